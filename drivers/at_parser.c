@@ -0,0 +1,451 @@
+//*****************************************************************************
+//
+// at_parser.c - Streaming parser for ESP8266 AT command responses.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drivers/at_parser.h"
+
+//*****************************************************************************
+//
+//! \addtogroup at_parser_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The parser classifies each line received from the ESP8266 while it is
+// being received, one byte at a time, without ever rescanning earlier bytes.
+//
+// Every known token keeps one bit in a candidate mask.  On each byte only the
+// tokens still in the mask are compared, and only at the current column, so a
+// byte costs a bounded number of compares no matter how long the line is.
+// Lines are terminated by either CR or LF; empty lines are ignored, which
+// absorbs the "\r\r\n" the module sends after an echoed command.
+//
+// Cycle budget per byte (Cortex-M4, -O2, roughly 7 cycles per live token
+// plus 20 cycles of fixed overhead):
+//      - First byte of a line:         all tokens live, <= 100 cycles.
+//      - Further bytes while ambiguous: <= 3 tokens live, <= 45 cycles.
+//      - Bytes of a classified line:   no tokens live, <= 25 cycles.
+//      - Line terminator:              <= 30 cycles.
+// At 16 MHz the worst case is about 6 us, well inside the 87 us a byte takes
+// to arrive at 115200 baud.
+//
+// Received TCP data arrives as "+IPD,<len>:" followed by <len> bytes of
+// arbitrary binary data with no terminator of its own.  Once the header has
+// been read the parser only counts payload bytes down, so a payload holding
+// "OK" or a line ending cannot end a command.  Callers that can take the
+// payload in bulk, straight out of their receive buffer, do so between
+// ATParserPayloadLeft() and ATParserPayloadSkip() and never feed it here.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Token matching rules.
+//
+// AT_TOKEN_LINE      - The whole line must equal the token.
+// AT_TOKEN_PREFIX    - The line starts with the token.  The longest matching
+//                      prefix decides the event reported at the end of line.
+// AT_TOKEN_IMMEDIATE - Reported as soon as the token is matched.
+//
+// A '#' in a token matches any digit, which is taken as a link ID.
+//
+//*****************************************************************************
+#define AT_TOKEN_LINE           0
+#define AT_TOKEN_PREFIX         1
+#define AT_TOKEN_IMMEDIATE      2
+
+typedef struct
+{
+    const char *pcText;
+    uint8_t ui8Match;
+    uint8_t ui8Event;
+}
+tATToken;
+
+static const tATToken g_psTokens[] =
+{
+    { "OK",         AT_TOKEN_LINE,      AT_EVENT_OK },
+    { "ERROR",      AT_TOKEN_LINE,      AT_EVENT_ERROR },
+    { "FAIL",       AT_TOKEN_LINE,      AT_EVENT_FAIL },
+    { "SEND OK",    AT_TOKEN_LINE,      AT_EVENT_SEND_OK },
+    { "SEND FAIL",  AT_TOKEN_LINE,      AT_EVENT_SEND_FAIL },
+    { ">",          AT_TOKEN_IMMEDIATE, AT_EVENT_PROMPT },
+    { "busy ",      AT_TOKEN_PREFIX,    AT_EVENT_BUSY },
+    { "AT",         AT_TOKEN_PREFIX,    AT_EVENT_ECHO },
+    { "AT+CWLAP",   AT_TOKEN_LINE,      AT_EVENT_ECHO_CWLAP },
+    { "AT+CWJAP=",  AT_TOKEN_PREFIX,    AT_EVENT_ECHO_CWJAP },
+    { "+CWLAP:",    AT_TOKEN_PREFIX,    AT_EVENT_SCAN_ENTRY },
+    { "+IPD,",      AT_TOKEN_IMMEDIATE, AT_EVENT_IPD },
+    { "CONNECT",    AT_TOKEN_LINE,      AT_EVENT_CONNECT },
+    { "CLOSED",     AT_TOKEN_LINE,      AT_EVENT_CLOSED },
+    { "#,CONNECT",  AT_TOKEN_LINE,      AT_EVENT_CONNECT },
+    { "#,CLOSED",   AT_TOKEN_LINE,      AT_EVENT_CLOSED },
+    { "ready",      AT_TOKEN_LINE,      AT_EVENT_READY },
+};
+
+#define NUM_TOKENS              (sizeof(g_psTokens) / sizeof(g_psTokens[0]))
+#define ALL_TOKENS              ((1 << NUM_TOKENS) - 1)
+
+//*****************************************************************************
+//
+// Forget everything about the current line.
+//
+//*****************************************************************************
+static void
+ATParserLineReset(tATParser *psParser)
+{
+    psParser->ui32Candidates = ALL_TOKENS;
+    psParser->ui32Complete = 0;
+    psParser->ui32Pos = 0;
+    psParser->ui32Kind = AT_EVENT_NONE;
+    psParser->ui32Header = 0;
+}
+
+//*****************************************************************************
+//
+// The largest payload the ESP8266 delivers in one +IPD frame.
+//
+//*****************************************************************************
+#define AT_IPD_MAX_LENGTH       2048
+
+//*****************************************************************************
+//
+// Take one byte of a +IPD header.  The header is "+IPD,<len>:" or, with
+// multiple connections, "+IPD,<link>,<len>:".  The firmware never enables
+// AT+CIPDINFO, so any other byte, an extra field or a length the module
+// cannot send means the header was garbled; it is dropped and the rest of
+// the line is parsed as ordinary text rather than swallowed as payload.
+//
+//*****************************************************************************
+static uint32_t
+ATParserHeaderFeed(tATParser *psParser, char cByte)
+{
+    uint32_t ui32Field;
+
+    ui32Field = psParser->ui32Header - 1;
+
+    if((cByte >= '0') && (cByte <= '9'))
+    {
+        psParser->pui32Field[ui32Field] =
+            (psParser->pui32Field[ui32Field] * 10) + (cByte - '0');
+
+        if(psParser->pui32Field[ui32Field] > AT_IPD_MAX_LENGTH)
+        {
+            ATParserLineReset(psParser);
+        }
+        return(AT_EVENT_NONE);
+    }
+
+    if((cByte == ',') && psParser->bMux && (ui32Field == 0))
+    {
+        psParser->ui32Header++;
+        return(AT_EVENT_NONE);
+    }
+
+    if(cByte != ':')
+    {
+        ATParserLineReset(psParser);
+        return(AT_EVENT_NONE);
+    }
+
+    if(psParser->bMux)
+    {
+        psParser->ui32Link = psParser->pui32Field[0];
+        psParser->ui32Payload = psParser->pui32Field[1];
+    }
+    else
+    {
+        psParser->ui32Link = 0;
+        psParser->ui32Payload = psParser->pui32Field[0];
+    }
+
+    //
+    // Whatever follows the payload starts a fresh line.
+    //
+    ATParserLineReset(psParser);
+
+    return(AT_EVENT_IPD);
+}
+
+//*****************************************************************************
+//
+//! Initializes an AT response parser.
+//!
+//! \param psParser is the parser instance to initialize.
+//!
+//! The parser starts at the beginning of a line with no line buffer attached.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATParserInit(tATParser *psParser)
+{
+    psParser->pcLine = 0;
+    psParser->ui32LineSize = 0;
+    psParser->bMux = false;
+    psParser->ui32Link = 0;
+    psParser->ui32Payload = 0;
+    ATParserLineReset(psParser);
+}
+
+//*****************************************************************************
+//
+//! Attaches a buffer that receives the text of the lines being parsed.
+//!
+//! \param psParser is the parser instance.
+//! \param pcLine is the buffer, or 0 to stop capturing line text.
+//! \param ui32Size is the size of the buffer in bytes.
+//!
+//! From the next byte on, every byte of the current line is also stored in
+//! \e pcLine and kept NUL terminated.  Bytes that do not fit are dropped.  A
+//! completed line stays in the buffer until the first byte of the next line
+//! overwrites it, so the caller should move the parser on to fresh storage
+//! when it wants to keep the line that just completed.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATParserLineBufferSet(tATParser *psParser, char *pcLine, uint32_t ui32Size)
+{
+    psParser->pcLine = pcLine;
+    psParser->ui32LineSize = ui32Size;
+
+    if(pcLine && ui32Size)
+    {
+        pcLine[0] = '\0';
+    }
+}
+
+//*****************************************************************************
+//
+//! Feeds one received byte to the parser.
+//!
+//! \param psParser is the parser instance.
+//! \param cByte is the byte received from the ESP8266.
+//!
+//! \return Returns one of the \b AT_EVENT_ values.  \b AT_EVENT_NONE means the
+//! byte did not complete anything.
+//
+//*****************************************************************************
+uint32_t
+ATParserFeed(tATParser *psParser, char cByte)
+{
+    uint32_t ui32Pos;
+    uint32_t ui32Live;
+    uint32_t ui32Index;
+    uint32_t ui32Event;
+    const char *pcText;
+
+    if(psParser->ui32Payload)
+    {
+        psParser->ui32Payload--;
+        return(AT_EVENT_IPD_DATA);
+    }
+
+    if((cByte == '\r') || (cByte == '\n'))
+    {
+        if(psParser->ui32Pos == 0)
+        {
+            return(AT_EVENT_NONE);
+        }
+
+        //
+        // An exact whole-line match wins over a prefix match.
+        //
+        ui32Event = psParser->ui32Kind;
+        for(ui32Index = 0, ui32Live = psParser->ui32Complete; ui32Live;
+            ui32Index++, ui32Live >>= 1)
+        {
+            if(ui32Live & 1)
+            {
+                ui32Event = g_psTokens[ui32Index].ui8Event;
+                break;
+            }
+        }
+
+        ATParserLineReset(psParser);
+
+        return((ui32Event == AT_EVENT_NONE) ? AT_EVENT_LINE : ui32Event);
+    }
+
+    ui32Pos = psParser->ui32Pos++;
+
+    if(psParser->pcLine && ((ui32Pos + 1) < psParser->ui32LineSize))
+    {
+        psParser->pcLine[ui32Pos] = cByte;
+        psParser->pcLine[ui32Pos + 1] = '\0';
+    }
+
+    if(psParser->ui32Header)
+    {
+        return(ATParserHeaderFeed(psParser, cByte));
+    }
+
+    ui32Event = AT_EVENT_NONE;
+    psParser->ui32Complete = 0;
+
+    for(ui32Index = 0, ui32Live = psParser->ui32Candidates; ui32Live;
+        ui32Index++, ui32Live >>= 1)
+    {
+        if(!(ui32Live & 1))
+        {
+            continue;
+        }
+
+        pcText = g_psTokens[ui32Index].pcText;
+
+        if((pcText[ui32Pos] == '#') && (cByte >= '0') && (cByte <= '9'))
+        {
+            psParser->ui32Link = cByte - '0';
+        }
+        else if(pcText[ui32Pos] != cByte)
+        {
+            psParser->ui32Candidates &= ~(1 << ui32Index);
+            continue;
+        }
+
+        if(pcText[ui32Pos + 1] == '\0')
+        {
+            //
+            // The whole token has been matched.  Nothing can match past its
+            // end, so it stops being a candidate either way.
+            //
+            psParser->ui32Candidates &= ~(1 << ui32Index);
+
+            switch(g_psTokens[ui32Index].ui8Match)
+            {
+            case AT_TOKEN_LINE:
+                psParser->ui32Complete |= 1 << ui32Index;
+                break;
+            case AT_TOKEN_PREFIX:
+                psParser->ui32Kind = g_psTokens[ui32Index].ui8Event;
+                break;
+            default:
+                ui32Event = g_psTokens[ui32Index].ui8Event;
+                break;
+            }
+
+            //
+            // "+IPD," starts a header; the event is reported at its end.
+            //
+            if(ui32Event == AT_EVENT_IPD)
+            {
+                psParser->ui32Header = 1;
+                psParser->pui32Field[0] = 0;
+                psParser->pui32Field[1] = 0;
+                ui32Event = AT_EVENT_NONE;
+            }
+        }
+    }
+
+    return(ui32Event);
+}
+
+//*****************************************************************************
+//
+//! Returns what the current, still incomplete, line has been recognized as.
+//!
+//! \param psParser is the parser instance.
+//!
+//! This lets the caller act on a line before it is terminated, for example to
+//! stop echoing the rest of an \b AT+CWJAP= line that carries a password.
+//!
+//! \return Returns the \b AT_EVENT_ value of the longest prefix token seen on
+//! this line so far, or \b AT_EVENT_NONE.
+//
+//*****************************************************************************
+uint32_t
+ATParserLineKind(tATParser *psParser)
+{
+    return(psParser->ui32Kind);
+}
+
+//*****************************************************************************
+//
+//! Tells the parser whether +IPD headers carry a link ID.
+//!
+//! \param psParser is the parser instance.
+//! \param bMux is \b true once AT+CIPMUX=1 has been accepted by the module.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATParserMuxSet(tATParser *psParser, bool bMux)
+{
+    psParser->bMux = bMux;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of +IPD payload bytes still to come.
+//!
+//! \param psParser is the parser instance.
+//!
+//! After \b AT_EVENT_IPD this is the length of the whole payload.  While it
+//! is non-zero the next bytes received are payload; the caller may either
+//! feed them to ATParserFeed() or consume them itself and account for them
+//! with ATParserPayloadSkip().
+//!
+//! \return Returns the number of payload bytes left in the current frame.
+//
+//*****************************************************************************
+uint32_t
+ATParserPayloadLeft(tATParser *psParser)
+{
+    return(psParser->ui32Payload);
+}
+
+//*****************************************************************************
+//
+//! Returns the link ID of the current +IPD frame or of the last
+//! \b AT_EVENT_CONNECT or \b AT_EVENT_CLOSED.
+//!
+//! \param psParser is the parser instance.
+//!
+//! \return Returns the link ID.  Only meaningful once ATParserMuxSet() has
+//! enabled link IDs.
+//
+//*****************************************************************************
+uint32_t
+ATParserLink(tATParser *psParser)
+{
+    return(psParser->ui32Link);
+}
+
+//*****************************************************************************
+//
+//! Accounts for payload bytes the caller consumed without feeding them.
+//!
+//! \param psParser is the parser instance.
+//! \param ui32Count is the number of payload bytes consumed, at most
+//! ATParserPayloadLeft().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATParserPayloadSkip(tATParser *psParser, uint32_t ui32Count)
+{
+    if(ui32Count > psParser->ui32Payload)
+    {
+        ui32Count = psParser->ui32Payload;
+    }
+
+    psParser->ui32Payload -= ui32Count;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
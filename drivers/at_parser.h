@@ -0,0 +1,149 @@
+//*****************************************************************************
+//
+// at_parser.h - Prototypes for the streaming ESP8266 AT response parser.
+//
+//*****************************************************************************
+
+#ifndef __AT_PARSER_H__
+#define __AT_PARSER_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Events returned by ATParserFeed().  Everything except AT_EVENT_PROMPT and
+// the +IPD events is reported on the byte that terminates a line (CR or LF).
+// AT_EVENT_PROMPT is reported on the '>' itself since the module does not
+// terminate the prompt.
+//
+// AT_EVENT_IPD is reported on the ':' that ends a "+IPD,<len>:" header.  The
+// <len> bytes that follow are payload and are reported as AT_EVENT_IPD_DATA
+// without being matched against any token, so received data can never be
+// mistaken for a response.
+//
+// AT_EVENT_CONNECT and AT_EVENT_CLOSED report a TCP link opening and closing.
+// ATParserLink() tells which link when AT+CIPMUX=1 is in effect.
+//
+// AT_EVENT_READY reports the module taking commands again after a restart.
+//
+//*****************************************************************************
+#define AT_EVENT_NONE           0
+#define AT_EVENT_OK             1
+#define AT_EVENT_ERROR          2
+#define AT_EVENT_FAIL           3
+#define AT_EVENT_SEND_OK        4
+#define AT_EVENT_SEND_FAIL      5
+#define AT_EVENT_PROMPT         6
+#define AT_EVENT_BUSY           7
+#define AT_EVENT_ECHO           8
+#define AT_EVENT_ECHO_CWLAP     9
+#define AT_EVENT_ECHO_CWJAP     10
+#define AT_EVENT_SCAN_ENTRY     11
+#define AT_EVENT_LINE           12
+#define AT_EVENT_IPD            13
+#define AT_EVENT_IPD_DATA       14
+#define AT_EVENT_CONNECT        15
+#define AT_EVENT_CLOSED         16
+#define AT_EVENT_READY          17
+
+//*****************************************************************************
+//
+// True for the events that end an AT command.
+//
+//*****************************************************************************
+#define AT_EVENT_IS_FINAL(ev)                                                 \
+        (((ev) >= AT_EVENT_OK) && ((ev) <= AT_EVENT_SEND_FAIL))
+
+//*****************************************************************************
+//
+// The state of one parser instance.  Treat as opaque; it is only exposed so
+// that instances can be allocated statically.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // Bit mask of the tokens still matching the current line.
+    //
+    uint32_t ui32Candidates;
+
+    //
+    // Bit mask of whole-line tokens matched exactly up to the current byte.
+    //
+    uint32_t ui32Complete;
+
+    //
+    // Number of bytes received on the current line.
+    //
+    uint32_t ui32Pos;
+
+    //
+    // Event of the longest prefix token recognized so far on this line.
+    //
+    uint32_t ui32Kind;
+
+    //
+    // Optional buffer that receives the text of the current line.
+    //
+    char *pcLine;
+    uint32_t ui32LineSize;
+
+    //
+    // Number of the +IPD header field being received, plus one, or 0 when
+    // not in a header.
+    //
+    uint32_t ui32Header;
+
+    //
+    // The numeric header fields received so far.
+    //
+    uint32_t pui32Field[2];
+
+    //
+    // True if headers carry a link ID, as they do with AT+CIPMUX=1.
+    //
+    bool bMux;
+
+    //
+    // Link ID of the current +IPD frame or of the last link event, and the
+    // payload bytes still to come.
+    //
+    uint32_t ui32Link;
+    uint32_t ui32Payload;
+}
+tATParser;
+
+//*****************************************************************************
+//
+// Functions exported from at_parser.c
+//
+//*****************************************************************************
+extern void ATParserInit(tATParser *psParser);
+extern void ATParserLineBufferSet(tATParser *psParser, char *pcLine,
+                                  uint32_t ui32Size);
+extern uint32_t ATParserFeed(tATParser *psParser, char cByte);
+extern uint32_t ATParserLineKind(tATParser *psParser);
+extern void ATParserMuxSet(tATParser *psParser, bool bMux);
+extern uint32_t ATParserPayloadLeft(tATParser *psParser);
+extern uint32_t ATParserLink(tATParser *psParser);
+extern void ATParserPayloadSkip(tATParser *psParser, uint32_t ui32Count);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __AT_PARSER_H__
@@ -0,0 +1,570 @@
+//*****************************************************************************
+//
+// at_queue.c - Queue of AT commands sent to the ESP8266 one after another.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "drivers/at_parser.h"
+#include "drivers/at_queue.h"
+
+//*****************************************************************************
+//
+//! \addtogroup at_queue_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The module works on one command at a time, and one sent while another is
+// running is answered with "busy p..." and dropped.  Callers queue commands
+// here instead of waiting for each other.  The next command goes out as soon
+// as the parser reports the end of the one before, before that command's
+// completion function has run, so a sequence of commands costs no more than
+// the module's own time.
+//
+// Each command carries a matcher that decides which parser events belong to
+// its reply and which of them ends it.  ATQueueMatchOK() suits commands that
+// end in OK, ERROR or FAIL.  ATQueueMatchSend() suits AT+CIPSEND, whose data
+// is written when the module prompts for it.
+//
+// A module that stops answering would otherwise hold the queue forever, so
+// every command runs against the timeout of its policy.  One that times out,
+// or that the module turns away as busy, is sent again up to the policy's
+// number of retries and then fails, and the queue moves on.  A reply that
+// comes in after its command was given up may be taken for the next
+// command's; the timeouts are set well above the module's slowest replies so
+// that this only happens when it has really stalled.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The policy of commands queued without one.
+//
+//*****************************************************************************
+static const tATPolicy g_sATQueueDefault =
+{
+    AT_QUEUE_TIMEOUT_MS, AT_QUEUE_RETRIES
+};
+
+//*****************************************************************************
+//
+//! Initializes a command queue.
+//!
+//! \param psQueue is the queue to initialize.
+//! \param pfnWrite is called to send a command or its data to the module.
+//! \param pfnClock returns the time in microseconds.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATQueueInit(tATQueue *psQueue, tATQueueWrite pfnWrite, tATQueueClock pfnClock)
+{
+    psQueue->ui32Read = 0;
+    psQueue->ui32Write = 0;
+    psQueue->bActive = false;
+    psQueue->bResend = false;
+    psQueue->pfnWrite = pfnWrite;
+    psQueue->pfnClock = pfnClock;
+    psQueue->pfnTiming = 0;
+    ATQueueStatsClear(psQueue);
+}
+
+//*****************************************************************************
+//
+// Write the running command and start its timeout.
+//
+//*****************************************************************************
+static void
+ATQueueSend(tATQueue *psQueue, tATCommand *psCommand)
+{
+    psCommand->bDataSent = false;
+    psQueue->ui32Sent = psQueue->pfnClock();
+    psQueue->ui32Deadline = psQueue->ui32Sent +
+                            (psCommand->psPolicy->ui32TimeoutMs * 1000);
+
+    psQueue->pfnWrite((const uint8_t *)psCommand->pcCommand,
+                      strlen(psCommand->pcCommand));
+}
+
+//*****************************************************************************
+//
+// Send the running command again, at once or after AT_QUEUE_RETRY_MS.
+// Returns false if it has no retries left or its data has gone out.
+//
+//*****************************************************************************
+static bool
+ATQueueRetry(tATQueue *psQueue, tATCommand *psCommand, bool bNow)
+{
+    if(psCommand->bDataSent ||
+       (psCommand->ui32Attempts > psCommand->psPolicy->ui32Retries))
+    {
+        return(false);
+    }
+
+    psCommand->ui32Attempts++;
+    psQueue->ui32Retries++;
+
+    if(bNow)
+    {
+        ATQueueSend(psQueue, psCommand);
+    }
+    else
+    {
+        psQueue->bResend = true;
+        psQueue->ui32Deadline = psQueue->pfnClock() +
+                                (AT_QUEUE_RETRY_MS * 1000);
+    }
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Send the command at the head of the queue if the module is free.
+//
+//*****************************************************************************
+static void
+ATQueueStart(tATQueue *psQueue)
+{
+    tATCommand *psCommand;
+    uint32_t ui32Wait;
+
+    if(psQueue->bActive || (psQueue->ui32Read == psQueue->ui32Write))
+    {
+        return;
+    }
+
+    psCommand = &psQueue->psCommands[psQueue->ui32Read % AT_QUEUE_DEPTH];
+
+    psQueue->bActive = true;
+    psQueue->ui32Started = psQueue->pfnClock();
+
+    ui32Wait = (psQueue->ui32Started - psCommand->ui32Queued) / 1000;
+    psQueue->ui32WaitTotal += ui32Wait;
+    if(ui32Wait > psQueue->ui32WaitMax)
+    {
+        psQueue->ui32WaitMax = ui32Wait;
+    }
+
+    ATQueueSend(psQueue, psCommand);
+}
+
+//*****************************************************************************
+//
+// End the running command, send the next and report the result.
+//
+//*****************************************************************************
+static void
+ATQueueFinish(tATQueue *psQueue, uint32_t ui32Result)
+{
+    tATCommand *psCommand;
+    tATQueueDone pfnDone;
+    void *pvArg;
+    uint32_t ui32Now;
+    uint32_t ui32Run;
+
+    psCommand = &psQueue->psCommands[psQueue->ui32Read % AT_QUEUE_DEPTH];
+    pfnDone = psCommand->pfnDone;
+    pvArg = psCommand->pvArg;
+
+    ui32Now = psQueue->pfnClock();
+    ui32Run = (ui32Now - psQueue->ui32Started) / 1000;
+
+    //
+    // The round trip of the last attempt, from writing the command to the
+    // result.  A command given up on has no round trip to report.
+    //
+    if(psQueue->pfnTiming && (ui32Result != AT_QUEUE_TIMEOUT))
+    {
+        psQueue->pfnTiming(psCommand->pcCommand, ui32Now - psQueue->ui32Sent,
+                           ui32Result);
+    }
+    psQueue->ui32RunTotal += ui32Run;
+    if(ui32Run > psQueue->ui32RunMax)
+    {
+        psQueue->ui32RunMax = ui32Run;
+    }
+
+    psQueue->ui32Commands++;
+    if(ui32Result != AT_QUEUE_OK)
+    {
+        psQueue->ui32Failed++;
+    }
+    else if(psQueue->bStalled)
+    {
+        psQueue->bStalled = false;
+        psQueue->ui32StallLast = (ui32Now - psQueue->ui32StallStart) / 1000;
+        if(psQueue->ui32StallLast > psQueue->ui32StallMax)
+        {
+            psQueue->ui32StallMax = psQueue->ui32StallLast;
+        }
+    }
+
+    psQueue->ui32Read++;
+    psQueue->bActive = false;
+    psQueue->bResend = false;
+
+    ATQueueStart(psQueue);
+
+    if(pfnDone)
+    {
+        pfnDone(pvArg, ui32Result);
+    }
+}
+
+//*****************************************************************************
+//
+//! Queues a command.
+//!
+//! \param psQueue is the queue.
+//! \param pcCommand is the command line, including its CR LF.  It is copied.
+//! \param pui8Data points to data to send when the module prompts for it, or
+//! is null.  It must stay in place until the command completes.
+//! \param ui32Count is the number of bytes of data.
+//! \param pfnMatch is the matcher for the command's reply.
+//! \param psPolicy is the command's timeout and retry policy, or is null for
+//! the default.  It must stay in place until the command completes.
+//! \param pfnDone is called with the result, or is null.
+//! \param pvArg is passed to \e pfnDone.
+//!
+//! The command is sent at once if the module is free.
+//!
+//! \return Returns \b false if the queue is full or the command too long.
+//
+//*****************************************************************************
+bool
+ATQueueAdd(tATQueue *psQueue, const char *pcCommand, const uint8_t *pui8Data,
+           uint32_t ui32Count, tATMatch pfnMatch, const tATPolicy *psPolicy,
+           tATQueueDone pfnDone, void *pvArg)
+{
+    tATCommand *psCommand;
+
+    if((ATQueueDepth(psQueue) == AT_QUEUE_DEPTH) ||
+       (strlen(pcCommand) >= AT_QUEUE_CMD_SIZE))
+    {
+        psQueue->ui32Refused++;
+        return(false);
+    }
+
+    psCommand = &psQueue->psCommands[psQueue->ui32Write % AT_QUEUE_DEPTH];
+    strcpy(psCommand->pcCommand, pcCommand);
+    psCommand->pui8Data = pui8Data;
+    psCommand->ui32Count = ui32Count;
+    psCommand->pfnMatch = pfnMatch;
+    psCommand->psPolicy = psPolicy ? psPolicy : &g_sATQueueDefault;
+    psCommand->ui32Attempts = 1;
+    psCommand->pfnDone = pfnDone;
+    psCommand->pvArg = pvArg;
+    psCommand->ui32Queued = psQueue->pfnClock();
+    psQueue->ui32Write++;
+
+    if(ATQueueDepth(psQueue) > psQueue->ui32MaxDepth)
+    {
+        psQueue->ui32MaxDepth = ATQueueDepth(psQueue);
+    }
+
+    ATQueueStart(psQueue);
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Offers a parser event to the running command.
+//!
+//! \param psQueue is the queue.
+//! \param ui32Event is the event returned by ATParserFeed().
+//!
+//! If the event ends the command its completion function is called, after
+//! the next command has been sent.
+//!
+//! \return Returns \b true if the event was part of the command's reply.
+//
+//*****************************************************************************
+bool
+ATQueueEvent(tATQueue *psQueue, uint32_t ui32Event)
+{
+    tATCommand *psCommand;
+
+    if(!psQueue->bActive || psQueue->bResend)
+    {
+        return(false);
+    }
+
+    psCommand = &psQueue->psCommands[psQueue->ui32Read % AT_QUEUE_DEPTH];
+
+    switch(psCommand->pfnMatch(ui32Event))
+    {
+    case AT_MATCH_MORE:
+        return(true);
+    case AT_MATCH_DATA:
+        //
+        // Without data the prompt itself is the success, as when starting
+        // transparent transmission.
+        //
+        if(psCommand->pui8Data)
+        {
+            psCommand->bDataSent = true;
+            psQueue->pfnWrite(psCommand->pui8Data, psCommand->ui32Count);
+            return(true);
+        }
+        ATQueueFinish(psQueue, AT_QUEUE_OK);
+        return(true);
+    case AT_MATCH_OK:
+        ATQueueFinish(psQueue, AT_QUEUE_OK);
+        return(true);
+    case AT_MATCH_FAIL:
+        ATQueueFinish(psQueue, AT_QUEUE_FAILED);
+        return(true);
+    case AT_MATCH_RETRY:
+        if(!ATQueueRetry(psQueue, psCommand, false))
+        {
+            ATQueueFinish(psQueue, AT_QUEUE_FAILED);
+        }
+        return(true);
+    default:
+        return(false);
+    }
+}
+
+//*****************************************************************************
+//
+//! Handles the running command's deadline.
+//!
+//! \param psQueue is the queue.
+//!
+//! Should be called once the time returned by ATQueueDeadline() is reached;
+//! calling it earlier or more often does no harm.  A command waiting to be
+//! sent again is sent, and one that has timed out is sent again or given up
+//! with \b AT_QUEUE_TIMEOUT.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATQueueTick(tATQueue *psQueue)
+{
+    tATCommand *psCommand;
+    uint32_t ui32Now;
+
+    ui32Now = psQueue->pfnClock();
+
+    if(!psQueue->bActive || ((int32_t)(ui32Now - psQueue->ui32Deadline) < 0))
+    {
+        return;
+    }
+
+    psCommand = &psQueue->psCommands[psQueue->ui32Read % AT_QUEUE_DEPTH];
+
+    if(psQueue->bResend)
+    {
+        psQueue->bResend = false;
+        ATQueueSend(psQueue, psCommand);
+        return;
+    }
+
+    psQueue->ui32Timeouts++;
+
+    //
+    // The module has said nothing since the command was sent.
+    //
+    if(!psQueue->bStalled)
+    {
+        psQueue->bStalled = true;
+        psQueue->ui32Stalls++;
+        psQueue->ui32StallStart = psQueue->ui32Sent;
+    }
+
+    if(!ATQueueRetry(psQueue, psCommand, true))
+    {
+        ATQueueFinish(psQueue, AT_QUEUE_TIMEOUT);
+    }
+}
+
+//*****************************************************************************
+//
+//! Returns when ATQueueTick() next has something to do.
+//!
+//! \param psQueue is the queue.
+//! \param pui32Deadline is set to the time, in microseconds.
+//!
+//! \return Returns \b false if no command is running.
+//
+//*****************************************************************************
+bool
+ATQueueDeadline(tATQueue *psQueue, uint32_t *pui32Deadline)
+{
+    *pui32Deadline = psQueue->ui32Deadline;
+
+    return(psQueue->bActive);
+}
+
+//*****************************************************************************
+//
+//! Sets the function told the round trip time of each command.
+//!
+//! \param psQueue is the queue.
+//! \param pfnTiming is called as each command completes, or is null.
+//!
+//! The time runs from the last write of the command to the event that ended
+//! it.  Commands that timed out are not reported.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATQueueTimingSet(tATQueue *psQueue, tATQueueTiming pfnTiming)
+{
+    psQueue->pfnTiming = pfnTiming;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of commands queued, including the running one.
+//!
+//! \param psQueue is the queue.
+//!
+//! \return Returns the number of commands.
+//
+//*****************************************************************************
+uint32_t
+ATQueueDepth(tATQueue *psQueue)
+{
+    return(psQueue->ui32Write - psQueue->ui32Read);
+}
+
+//*****************************************************************************
+//
+//! Clears the statistics.
+//!
+//! \param psQueue is the queue.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ATQueueStatsClear(tATQueue *psQueue)
+{
+    psQueue->ui32Commands = 0;
+    psQueue->ui32Failed = 0;
+    psQueue->ui32Refused = 0;
+    psQueue->ui32MaxDepth = 0;
+    psQueue->ui32WaitTotal = 0;
+    psQueue->ui32WaitMax = 0;
+    psQueue->ui32RunTotal = 0;
+    psQueue->ui32RunMax = 0;
+    psQueue->ui32Timeouts = 0;
+    psQueue->ui32Retries = 0;
+    psQueue->ui32Stalls = 0;
+    psQueue->ui32StallLast = 0;
+    psQueue->ui32StallMax = 0;
+    psQueue->bStalled = false;
+}
+
+//*****************************************************************************
+//
+//! Matches the reply of a command that ends in OK, ERROR or FAIL.
+//!
+//! \param ui32Event is the parser event.
+//!
+//! A "busy" reply means the module dropped the command, which is then sent
+//! again if its policy allows.
+//!
+//! \return Returns one of the \b AT_MATCH_ values.
+//
+//*****************************************************************************
+uint32_t
+ATQueueMatchOK(uint32_t ui32Event)
+{
+    switch(ui32Event)
+    {
+    case AT_EVENT_OK:
+        return(AT_MATCH_OK);
+    case AT_EVENT_ERROR:
+    case AT_EVENT_FAIL:
+        return(AT_MATCH_FAIL);
+    case AT_EVENT_BUSY:
+        return(AT_MATCH_RETRY);
+    default:
+        return(AT_MATCH_NONE);
+    }
+}
+
+//*****************************************************************************
+//
+//! Matches the reply of AT+CIPSEND.
+//!
+//! \param ui32Event is the parser event.
+//!
+//! The module answers OK and prompts for the data, then reports SEND OK or
+//! SEND FAIL once it is sent.  An error in place of the prompt ends the
+//! command.
+//!
+//! \return Returns one of the \b AT_MATCH_ values.
+//
+//*****************************************************************************
+uint32_t
+ATQueueMatchSend(uint32_t ui32Event)
+{
+    switch(ui32Event)
+    {
+    case AT_EVENT_OK:
+        return(AT_MATCH_MORE);
+    case AT_EVENT_PROMPT:
+        return(AT_MATCH_DATA);
+    case AT_EVENT_SEND_OK:
+        return(AT_MATCH_OK);
+    case AT_EVENT_ERROR:
+    case AT_EVENT_FAIL:
+    case AT_EVENT_SEND_FAIL:
+        return(AT_MATCH_FAIL);
+    case AT_EVENT_BUSY:
+        return(AT_MATCH_RETRY);
+    default:
+        return(AT_MATCH_NONE);
+    }
+}
+
+//*****************************************************************************
+//
+//! Matches the reply of a command that restarts the module.
+//!
+//! \param ui32Event is the parser event.
+//!
+//! AT+RST and AT+RESTORE answer OK, then the module restarts and reports
+//! "ready" once it takes commands again.
+//!
+//! \return Returns one of the \b AT_MATCH_ values.
+//
+//*****************************************************************************
+uint32_t
+ATQueueMatchReady(uint32_t ui32Event)
+{
+    switch(ui32Event)
+    {
+    case AT_EVENT_OK:
+        return(AT_MATCH_MORE);
+    case AT_EVENT_READY:
+        return(AT_MATCH_OK);
+    case AT_EVENT_ERROR:
+    case AT_EVENT_FAIL:
+        return(AT_MATCH_FAIL);
+    case AT_EVENT_BUSY:
+        return(AT_MATCH_RETRY);
+    default:
+        return(AT_MATCH_NONE);
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
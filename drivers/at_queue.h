@@ -0,0 +1,189 @@
+//*****************************************************************************
+//
+// at_queue.h - Prototypes for the queue of AT commands sent to the ESP8266.
+//
+//*****************************************************************************
+
+#ifndef __AT_QUEUE_H__
+#define __AT_QUEUE_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The number of commands that can wait in the queue, including the one the
+// module is working on, and the longest command line, terminator included.
+//
+//*****************************************************************************
+#define AT_QUEUE_DEPTH          8
+#define AT_QUEUE_CMD_SIZE       128
+
+//*****************************************************************************
+//
+// The policy used for commands queued without one, and how long to wait
+// before sending a command again after the module answered "busy".
+//
+//*****************************************************************************
+#define AT_QUEUE_TIMEOUT_MS     1000
+#define AT_QUEUE_RETRIES        2
+#define AT_QUEUE_RETRY_MS       100
+
+//*****************************************************************************
+//
+// Results passed to a command's completion function.
+//
+//*****************************************************************************
+#define AT_QUEUE_OK             0
+#define AT_QUEUE_FAILED         1
+#define AT_QUEUE_TIMEOUT        2
+
+//*****************************************************************************
+//
+// What a matcher makes of a parser event while its command is running.
+//
+//*****************************************************************************
+#define AT_MATCH_NONE           0   // Not part of the reply
+#define AT_MATCH_MORE           1   // Part of the reply, more to come
+#define AT_MATCH_DATA           2   // The module wants the command's data
+#define AT_MATCH_OK             3   // The command succeeded
+#define AT_MATCH_FAIL           4   // The command failed
+#define AT_MATCH_RETRY          5   // The module dropped the command
+
+//*****************************************************************************
+//
+// A matcher is given each parser event while its command runs and returns
+// one of the AT_MATCH_ values.  The completion function is called once with
+// the command's result.  The write function sends bytes to the module, and
+// the clock function returns the time in microseconds, modulo 2^32.  The
+// timing function is told each command's round trip time in microseconds.
+//
+//*****************************************************************************
+typedef uint32_t (*tATMatch)(uint32_t ui32Event);
+typedef void (*tATQueueDone)(void *pvArg, uint32_t ui32Result);
+typedef void (*tATQueueWrite)(const uint8_t *pui8Data, uint32_t ui32Count);
+typedef uint32_t (*tATQueueClock)(void);
+typedef void (*tATQueueTiming)(const char *pcCommand, uint32_t ui32Us,
+                               uint32_t ui32Result);
+
+//*****************************************************************************
+//
+// How long a command may run before it is given up, and how many times it is
+// sent again after a timeout or a "busy" reply before it fails.  A command
+// whose data has been written is never sent again, as the data may have gone
+// out.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32TimeoutMs;
+    uint32_t ui32Retries;
+}
+tATPolicy;
+
+//*****************************************************************************
+//
+// A queued command.  The command line is copied in; the data, if any, is
+// only pointed at and must stay in place until the command completes.
+//
+//*****************************************************************************
+typedef struct
+{
+    char pcCommand[AT_QUEUE_CMD_SIZE];
+    const uint8_t *pui8Data;
+    uint32_t ui32Count;
+    tATMatch pfnMatch;
+    const tATPolicy *psPolicy;
+    tATQueueDone pfnDone;
+    void *pvArg;
+    uint32_t ui32Queued;
+    uint32_t ui32Attempts;
+    bool bDataSent;
+}
+tATCommand;
+
+//*****************************************************************************
+//
+// The command queue.  The command at ui32Read is the one the module is
+// working on whenever bActive is set.  It was first sent at ui32Started and
+// last sent at ui32Sent.  ui32Deadline is when it times out, or, with
+// bResend set, when it is to be sent again.
+//
+//*****************************************************************************
+typedef struct
+{
+    tATCommand psCommands[AT_QUEUE_DEPTH];
+    uint32_t ui32Read;
+    uint32_t ui32Write;
+    bool bActive;
+    bool bResend;
+    uint32_t ui32Started;
+    uint32_t ui32Sent;
+    uint32_t ui32Deadline;
+    tATQueueWrite pfnWrite;
+    tATQueueClock pfnClock;
+    tATQueueTiming pfnTiming;
+
+    //
+    // Counters since ATQueueStatsClear().  Times are in milliseconds; the
+    // wait is from being queued to being sent, the run from being sent to
+    // completing.  A stall starts with a timeout and lasts until a command
+    // succeeds again; ui32StallLast and ui32StallMax are the recovery times.
+    //
+    uint32_t ui32Commands;
+    uint32_t ui32Failed;
+    uint32_t ui32Refused;
+    uint32_t ui32MaxDepth;
+    uint32_t ui32WaitTotal;
+    uint32_t ui32WaitMax;
+    uint32_t ui32RunTotal;
+    uint32_t ui32RunMax;
+    uint32_t ui32Timeouts;
+    uint32_t ui32Retries;
+    uint32_t ui32Stalls;
+    uint32_t ui32StallLast;
+    uint32_t ui32StallMax;
+    bool bStalled;
+    uint32_t ui32StallStart;
+}
+tATQueue;
+
+//*****************************************************************************
+//
+// Functions exported from at_queue.c
+//
+//*****************************************************************************
+extern void ATQueueInit(tATQueue *psQueue, tATQueueWrite pfnWrite,
+                        tATQueueClock pfnClock);
+extern bool ATQueueAdd(tATQueue *psQueue, const char *pcCommand,
+                       const uint8_t *pui8Data, uint32_t ui32Count,
+                       tATMatch pfnMatch, const tATPolicy *psPolicy,
+                       tATQueueDone pfnDone, void *pvArg);
+extern bool ATQueueEvent(tATQueue *psQueue, uint32_t ui32Event);
+extern void ATQueueTick(tATQueue *psQueue);
+extern bool ATQueueDeadline(tATQueue *psQueue, uint32_t *pui32Deadline);
+extern void ATQueueTimingSet(tATQueue *psQueue, tATQueueTiming pfnTiming);
+extern uint32_t ATQueueDepth(tATQueue *psQueue);
+extern void ATQueueStatsClear(tATQueue *psQueue);
+extern uint32_t ATQueueMatchOK(uint32_t ui32Event);
+extern uint32_t ATQueueMatchSend(uint32_t ui32Event);
+extern uint32_t ATQueueMatchReady(uint32_t ui32Event);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __AT_QUEUE_H__
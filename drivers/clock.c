@@ -0,0 +1,182 @@
+//*****************************************************************************
+//
+// clock.c - Monotonic millisecond and microsecond clock kept by SysTick.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/systick.h"
+#include "drivers/clock.h"
+
+//*****************************************************************************
+//
+//! \addtogroup clock_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The SysTick interrupt counts whole ticks, and the time within a tick is
+// read from the SysTick down counter, so the clock has the resolution of the
+// processor clock without interrupting any faster than the tick rate.
+//
+// The tick count and the counter cannot be read together.  The count is read
+// on both sides of the counter and the read repeated if a tick came between.
+// With interrupts masked a tick that falls due is not counted until they are
+// unmasked, and a reading taken meanwhile may be up to one tick behind.  The
+// SysTick handler itself reads the clock right after the tick it counts.
+//
+// ClockInit() may be called again when the processor clock changes.  The time
+// reached so far is kept as the base of the new tick count, so the clock
+// never runs backwards across the change.
+//
+//*****************************************************************************
+static volatile uint32_t g_ui32ClockTicks;
+static uint64_t g_ui64ClockBase;
+static uint32_t g_ui32ClockPeriod;
+static uint32_t g_ui32ClockPerUs;
+static uint32_t g_ui32ClockTickUs;
+
+//*****************************************************************************
+//
+//! Starts, or restarts, the clock.
+//!
+//! \param ui32SysClock is the processor clock in Hz, a whole number of MHz.
+//! \param ui32TickHz is the SysTick interrupt rate, a divisor of 1000000.
+//!
+//! SysTick is configured and its interrupt enabled.  The interrupt handler
+//! must call ClockTick().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ClockInit(uint32_t ui32SysClock, uint32_t ui32TickHz)
+{
+    bool bMasked;
+
+    bMasked = IntMasterDisable();
+
+    if(g_ui32ClockPeriod)
+    {
+        g_ui64ClockBase = ClockUs64();
+    }
+
+    g_ui32ClockTicks = 0;
+    g_ui32ClockPeriod = ui32SysClock / ui32TickHz;
+    g_ui32ClockPerUs = ui32SysClock / 1000000;
+    g_ui32ClockTickUs = 1000000 / ui32TickHz;
+
+    SysTickDisable();
+    SysTickPeriodSet(g_ui32ClockPeriod);
+
+    //
+    // Clear the counter so the new period starts now rather than after the
+    // old one runs down.
+    //
+    HWREG(NVIC_ST_CURRENT) = 0;
+
+    SysTickIntEnable();
+    SysTickEnable();
+
+    if(!bMasked)
+    {
+        IntMasterEnable();
+    }
+}
+
+//*****************************************************************************
+//
+//! Counts a tick.  Called from the SysTick interrupt handler.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ClockTick(void)
+{
+    g_ui32ClockTicks++;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of ticks since ClockInit() was last called.
+//!
+//! \return Returns the tick count.
+//
+//*****************************************************************************
+uint32_t
+ClockTicks(void)
+{
+    return(g_ui32ClockTicks);
+}
+
+//*****************************************************************************
+//
+//! Returns the time since start up in microseconds.
+//!
+//! \return Returns the time, which does not wrap in practice.
+//
+//*****************************************************************************
+uint64_t
+ClockUs64(void)
+{
+    uint32_t ui32Ticks;
+    uint32_t ui32Value;
+
+    if(g_ui32ClockPeriod == 0)
+    {
+        return(0);
+    }
+
+    do
+    {
+        ui32Ticks = g_ui32ClockTicks;
+        ui32Value = SysTickValueGet();
+    }
+    while(ui32Ticks != g_ui32ClockTicks);
+
+    return(g_ui64ClockBase + ((uint64_t)ui32Ticks * g_ui32ClockTickUs) +
+           ((g_ui32ClockPeriod - 1 - ui32Value) / g_ui32ClockPerUs));
+}
+
+//*****************************************************************************
+//
+//! Returns the time since start up in microseconds, modulo 2^32.
+//!
+//! Differences between two readings are correct across the wrap for spans of
+//! up to 71 minutes.
+//!
+//! \return Returns the time.
+//
+//*****************************************************************************
+uint32_t
+ClockUs(void)
+{
+    return((uint32_t)ClockUs64());
+}
+
+//*****************************************************************************
+//
+//! Returns the time since start up in milliseconds, modulo 2^32.
+//!
+//! \return Returns the time.
+//
+//*****************************************************************************
+uint32_t
+ClockMs(void)
+{
+    return((uint32_t)(ClockUs64() / 1000));
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
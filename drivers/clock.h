@@ -0,0 +1,42 @@
+//*****************************************************************************
+//
+// clock.h - Prototypes for the SysTick based monotonic clock.
+//
+//*****************************************************************************
+
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Functions exported from clock.c
+//
+//*****************************************************************************
+extern void ClockInit(uint32_t ui32SysClock, uint32_t ui32TickHz);
+extern void ClockTick(void);
+extern uint32_t ClockTicks(void);
+extern uint64_t ClockUs64(void);
+extern uint32_t ClockUs(void);
+extern uint32_t ClockMs(void);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CLOCK_H__
@@ -0,0 +1,209 @@
+//*****************************************************************************
+//
+// coalesce.c - Packs short outgoing messages into one AT+CIPSEND.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "drivers/coalesce.h"
+
+//*****************************************************************************
+//
+//! \addtogroup coalesce_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Every AT+CIPSEND costs a command, a prompt and a SEND OK on top of the
+// payload, which is most of the time on the link for a short message.  Like
+// Nagle's algorithm, messages are held back and sent together when the
+// buffer would overflow, when the oldest one has waited for the flush time,
+// or when the caller asks for it.  Messages are never split across sends.
+//
+// The buffer only stores and counts.  Sending, and running the flush timer
+// that calls CoalesceTimeout(), is left to the caller.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Initializes a coalescing buffer.
+//!
+//! \param psCoalesce is the buffer to initialize.
+//! \param pui8Buf is the storage for waiting messages.
+//! \param ui32Size is the size of \e pui8Buf, at most
+//! \b COALESCE_MAX_SEND.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+CoalesceInit(tCoalesce *psCoalesce, uint8_t *pui8Buf, uint32_t ui32Size)
+{
+    psCoalesce->pui8Buf = pui8Buf;
+    psCoalesce->ui32Size = ui32Size;
+    psCoalesce->ui32Used = 0;
+    psCoalesce->ui32Messages = 0;
+    psCoalesce->bDue = false;
+    CoalesceStatsClear(psCoalesce);
+}
+
+//*****************************************************************************
+//
+//! Checks whether a message fits behind the ones already waiting.
+//!
+//! \param psCoalesce is the buffer.
+//! \param ui32Count is the length of the message, without separator.
+//!
+//! \return Returns \b true if CoalesceAdd() would accept the message.
+//
+//*****************************************************************************
+bool
+CoalesceFits(tCoalesce *psCoalesce, uint32_t ui32Count)
+{
+    return((ui32Count + 1) <= (psCoalesce->ui32Size - psCoalesce->ui32Used));
+}
+
+//*****************************************************************************
+//
+//! Adds a message to the buffer.
+//!
+//! \param psCoalesce is the buffer.
+//! \param pui8Data points to the message.
+//! \param ui32Count is the length of the message.
+//!
+//! The message is followed by \b COALESCE_SEPARATOR.  If it does not fit,
+//! the waiting messages must be flushed first; a message larger than the
+//! whole buffer is never accepted.
+//!
+//! \return Returns \b true if the message was added.
+//
+//*****************************************************************************
+bool
+CoalesceAdd(tCoalesce *psCoalesce, const uint8_t *pui8Data,
+            uint32_t ui32Count)
+{
+    if(!CoalesceFits(psCoalesce, ui32Count))
+    {
+        return(false);
+    }
+
+    memcpy(psCoalesce->pui8Buf + psCoalesce->ui32Used, pui8Data, ui32Count);
+    psCoalesce->ui32Used += ui32Count;
+    psCoalesce->pui8Buf[psCoalesce->ui32Used++] = COALESCE_SEPARATOR;
+    psCoalesce->ui32Messages++;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Returns the waiting messages.
+//!
+//! \param psCoalesce is the buffer.
+//! \param ppui8Data receives a pointer to the first waiting byte.
+//!
+//! The bytes stay in place until CoalesceSent() is called.
+//!
+//! \return Returns the number of bytes waiting.
+//
+//*****************************************************************************
+uint32_t
+CoalescePending(tCoalesce *psCoalesce, uint8_t **ppui8Data)
+{
+    *ppui8Data = psCoalesce->pui8Buf;
+
+    return(psCoalesce->ui32Used);
+}
+
+//*****************************************************************************
+//
+//! Empties the buffer after its contents have been sent.
+//!
+//! \param psCoalesce is the buffer.
+//! \param ui32Reason is the reason for the flush, one of
+//! \b COALESCE_FLUSH_SIZE, \b COALESCE_FLUSH_TIMER or
+//! \b COALESCE_FLUSH_MARKER.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+CoalesceSent(tCoalesce *psCoalesce, uint32_t ui32Reason)
+{
+    if(psCoalesce->ui32Messages)
+    {
+        psCoalesce->ui32Sends++;
+        psCoalesce->ui32SentMessages += psCoalesce->ui32Messages;
+        psCoalesce->ui32SentBytes += psCoalesce->ui32Used;
+
+        if(psCoalesce->ui32Messages > psCoalesce->ui32MaxMessages)
+        {
+            psCoalesce->ui32MaxMessages = psCoalesce->ui32Messages;
+        }
+
+        if(ui32Reason < COALESCE_NUM_REASONS)
+        {
+            psCoalesce->ui32Flushes[ui32Reason]++;
+        }
+    }
+
+    psCoalesce->ui32Used = 0;
+    psCoalesce->ui32Messages = 0;
+    psCoalesce->bDue = false;
+}
+
+//*****************************************************************************
+//
+//! Marks the waiting messages as due.  Called from the flush timer
+//! interrupt.
+//!
+//! \param psCoalesce is the buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+CoalesceTimeout(tCoalesce *psCoalesce)
+{
+    if(psCoalesce->ui32Messages)
+    {
+        psCoalesce->bDue = true;
+    }
+}
+
+//*****************************************************************************
+//
+//! Clears the counters.
+//!
+//! \param psCoalesce is the buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+CoalesceStatsClear(tCoalesce *psCoalesce)
+{
+    uint32_t ui32Reason;
+
+    psCoalesce->ui32Sends = 0;
+    psCoalesce->ui32SentMessages = 0;
+    psCoalesce->ui32SentBytes = 0;
+    psCoalesce->ui32MaxMessages = 0;
+
+    for(ui32Reason = 0; ui32Reason < COALESCE_NUM_REASONS; ui32Reason++)
+    {
+        psCoalesce->ui32Flushes[ui32Reason] = 0;
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
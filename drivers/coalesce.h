@@ -0,0 +1,103 @@
+//*****************************************************************************
+//
+// coalesce.h - Prototypes for the outgoing message coalescing buffer.
+//
+//*****************************************************************************
+
+#ifndef __COALESCE_H__
+#define __COALESCE_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The largest payload the ESP8266 accepts in one AT+CIPSEND.
+//
+//*****************************************************************************
+#define COALESCE_MAX_SEND       2048
+
+//*****************************************************************************
+//
+// Byte appended to each message so the receiver can split a coalesced send.
+//
+//*****************************************************************************
+#define COALESCE_SEPARATOR      '\n'
+
+//*****************************************************************************
+//
+// Why a buffer was flushed.  Used to index ui32Flushes[].
+//
+//*****************************************************************************
+#define COALESCE_FLUSH_SIZE     0
+#define COALESCE_FLUSH_TIMER    1
+#define COALESCE_FLUSH_MARKER   2
+#define COALESCE_NUM_REASONS    3
+
+//*****************************************************************************
+//
+// A buffer that packs messages for one send, with counters describing how
+// well it packed.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint8_t *pui8Buf;
+    uint32_t ui32Size;
+
+    //
+    // Bytes and messages waiting to be sent.
+    //
+    uint32_t ui32Used;
+    uint32_t ui32Messages;
+
+    //
+    // Set from the flush timer interrupt once the oldest waiting message has
+    // waited long enough.
+    //
+    volatile bool bDue;
+
+    //
+    // Counters since CoalesceInit() or CoalesceStatsClear().
+    //
+    uint32_t ui32Sends;
+    uint32_t ui32SentMessages;
+    uint32_t ui32SentBytes;
+    uint32_t ui32MaxMessages;
+    uint32_t ui32Flushes[COALESCE_NUM_REASONS];
+}
+tCoalesce;
+
+//*****************************************************************************
+//
+// Functions exported from coalesce.c
+//
+//*****************************************************************************
+extern void CoalesceInit(tCoalesce *psCoalesce, uint8_t *pui8Buf,
+                         uint32_t ui32Size);
+extern bool CoalesceFits(tCoalesce *psCoalesce, uint32_t ui32Count);
+extern bool CoalesceAdd(tCoalesce *psCoalesce, const uint8_t *pui8Data,
+                        uint32_t ui32Count);
+extern uint32_t CoalescePending(tCoalesce *psCoalesce, uint8_t **ppui8Data);
+extern void CoalesceSent(tCoalesce *psCoalesce, uint32_t ui32Reason);
+extern void CoalesceTimeout(tCoalesce *psCoalesce);
+extern void CoalesceStatsClear(tCoalesce *psCoalesce);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __COALESCE_H__
@@ -0,0 +1,190 @@
+//*****************************************************************************
+//
+// event_queue.c - Interrupt-fed event queue for a run-to-completion main loop.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "drivers/event_queue.h"
+
+//*****************************************************************************
+//
+//! \addtogroup event_queue_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Interrupt handlers do the minimum: move data into a ring, set a flag and
+// post an event saying what happened.  The main loop takes the events one at
+// a time and runs each to completion, and when none are left it sleeps in WFI
+// until the next interrupt.
+//
+// An event already waiting in the queue is not queued again; it only tells
+// the main loop to look at something, and looking once covers every post
+// made before it gets there.  That bounds the queue at one slot per event
+// number and keeps a burst of interrupts from flooding it.
+//
+// Any number of interrupt handlers may post, so every queue update is made
+// with interrupts masked.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Initializes an event queue.
+//!
+//! \param psQueue is the queue to initialize.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+EventQueueInit(tEventQueue *psQueue)
+{
+    psQueue->ui32Write = 0;
+    psQueue->ui32Read = 0;
+    psQueue->ui32Queued = 0;
+    psQueue->ui32Posted = 0;
+    psQueue->ui32Merged = 0;
+    psQueue->ui32Sleeps = 0;
+}
+
+//*****************************************************************************
+//
+//! Posts an event.
+//!
+//! \param psQueue is the queue.
+//! \param ui32Event is the event, from 1 to \b EVENT_MAX.
+//!
+//! May be called from interrupt handlers and from the main loop.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+EventPost(tEventQueue *psQueue, uint32_t ui32Event)
+{
+    bool bMasked;
+
+    bMasked = IntMasterDisable();
+
+    psQueue->ui32Posted++;
+
+    if(psQueue->ui32Queued & (1 << ui32Event))
+    {
+        psQueue->ui32Merged++;
+    }
+    else
+    {
+        psQueue->pui8Queue[psQueue->ui32Write % EVENT_QUEUE_SIZE] = ui32Event;
+        psQueue->ui32Write++;
+        psQueue->ui32Queued |= 1 << ui32Event;
+    }
+
+    if(!bMasked)
+    {
+        IntMasterEnable();
+    }
+}
+
+//*****************************************************************************
+//
+// Take the oldest event.  Must be called with interrupts masked.
+//
+//*****************************************************************************
+static uint32_t
+EventTake(tEventQueue *psQueue)
+{
+    uint32_t ui32Event;
+
+    if(psQueue->ui32Read == psQueue->ui32Write)
+    {
+        return(EVENT_NONE);
+    }
+
+    ui32Event = psQueue->pui8Queue[psQueue->ui32Read % EVENT_QUEUE_SIZE];
+    psQueue->ui32Read++;
+    psQueue->ui32Queued &= ~(1 << ui32Event);
+
+    return(ui32Event);
+}
+
+//*****************************************************************************
+//
+//! Takes the oldest event without waiting.
+//!
+//! \param psQueue is the queue.
+//!
+//! \return Returns the event, or \b EVENT_NONE if the queue is empty.
+//
+//*****************************************************************************
+uint32_t
+EventGet(tEventQueue *psQueue)
+{
+    uint32_t ui32Event;
+    bool bMasked;
+
+    bMasked = IntMasterDisable();
+    ui32Event = EventTake(psQueue);
+    if(!bMasked)
+    {
+        IntMasterEnable();
+    }
+
+    return(ui32Event);
+}
+
+//*****************************************************************************
+//
+//! Takes the oldest event, sleeping until there is one.
+//!
+//! \param psQueue is the queue.
+//!
+//! The queue is checked with interrupts masked and the processor sleeps with
+//! them still masked.  WFI wakes on an interrupt that becomes pending even
+//! while masked, so an event posted between the check and the sleep cannot
+//! be missed; the interrupt is taken as soon as they are unmasked again.
+//!
+//! \return Returns the event.
+//
+//*****************************************************************************
+uint32_t
+EventWait(tEventQueue *psQueue)
+{
+    uint32_t ui32Event;
+    bool bMasked;
+
+    while(1)
+    {
+        bMasked = IntMasterDisable();
+
+        ui32Event = EventTake(psQueue);
+        if(ui32Event == EVENT_NONE)
+        {
+            psQueue->ui32Sleeps++;
+            SysCtlSleep();
+        }
+
+        if(!bMasked)
+        {
+            IntMasterEnable();
+        }
+
+        if(ui32Event != EVENT_NONE)
+        {
+            return(ui32Event);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,82 @@
+//*****************************************************************************
+//
+// event_queue.h - Prototypes for the interrupt-fed main loop event queue.
+//
+//*****************************************************************************
+
+#ifndef __EVENT_QUEUE_H__
+#define __EVENT_QUEUE_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Event numbers are chosen by the application, from 1 to EVENT_MAX.
+// EVENT_NONE is returned by EventGet() when nothing is waiting.
+//
+//*****************************************************************************
+#define EVENT_NONE              0
+#define EVENT_MAX               31
+
+//*****************************************************************************
+//
+// The queue holds each event number at most once, so it can never overflow.
+//
+//*****************************************************************************
+#define EVENT_QUEUE_SIZE        32
+
+//*****************************************************************************
+//
+// An event queue.  Events are posted from interrupt handlers or the main loop
+// and taken by the main loop in the order they were first posted.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint8_t pui8Queue[EVENT_QUEUE_SIZE];
+    volatile uint32_t ui32Write;
+    volatile uint32_t ui32Read;
+
+    //
+    // Bit mask of the events waiting in the queue.
+    //
+    volatile uint32_t ui32Queued;
+
+    //
+    // Counters since EventQueueInit().
+    //
+    volatile uint32_t ui32Posted;
+    volatile uint32_t ui32Merged;
+    uint32_t ui32Sleeps;
+}
+tEventQueue;
+
+//*****************************************************************************
+//
+// Functions exported from event_queue.c
+//
+//*****************************************************************************
+extern void EventQueueInit(tEventQueue *psQueue);
+extern void EventPost(tEventQueue *psQueue, uint32_t ui32Event);
+extern uint32_t EventGet(tEventQueue *psQueue);
+extern uint32_t EventWait(tEventQueue *psQueue);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __EVENT_QUEUE_H__
@@ -0,0 +1,248 @@
+//*****************************************************************************
+//
+// governor.c - System clock profiles and a governor that switches them.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "drivers/clock.h"
+#include "drivers/governor.h"
+
+//*****************************************************************************
+//
+//! \addtogroup governor_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The processor only needs its full speed while bytes are moving: parsing,
+// queueing uDMA transfers and formatting output.  The rest of the time it
+// waits in WFI for the next interrupt, and a slower clock draws less current
+// there.  The governor raises the clock as soon as the application reports
+// activity and lowers it once there has been none for a while; the check
+// for the idle time is cheap enough for a periodic interrupt handler, which
+// then has the main loop call GovernorIdle().
+//
+// A switch re-locks the PLL with interrupts masked, then hands the old and
+// new clock rates to the application, which reloads everything that counts
+// in system clock cycles.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Switches to a profile.
+//
+//*****************************************************************************
+static void
+GovernorSwitch(tGovernor *psGovernor, uint32_t ui32Profile)
+{
+    uint32_t ui32OldHz;
+    uint64_t ui64Now;
+    bool bMasked;
+
+    if(ui32Profile == psGovernor->ui32Current)
+    {
+        return;
+    }
+
+    bMasked = IntMasterDisable();
+
+    ui64Now = ClockUs64();
+    psGovernor->pui64Us[psGovernor->ui32Current] +=
+        ui64Now - psGovernor->ui64Since;
+    psGovernor->ui64Since = ui64Now;
+
+    ui32OldHz = SysCtlClockGet();
+    SysCtlClockSet(psGovernor->psProfiles[ui32Profile].ui32Config);
+    psGovernor->ui32Current = ui32Profile;
+    psGovernor->ui32Switches++;
+
+    psGovernor->pfnApply(ui32OldHz, SysCtlClockGet());
+
+    if(!bMasked)
+    {
+        IntMasterEnable();
+    }
+}
+
+//*****************************************************************************
+//
+//! Sets up a governor and selects its high profile.
+//!
+//! \param psGovernor is the governor.
+//! \param psProfiles is the table of profiles, at most GOVERNOR_PROFILES.
+//! \param ui32Count is the number of profiles.
+//! \param ui32Low is the profile to run at while idle.
+//! \param ui32High is the profile to run at while busy.
+//! \param ui32IdleMs is the time without activity after which the governor
+//! lowers the clock.
+//! \param pfnApply is called after each switch.
+//!
+//! The clock is set without calling \e pfnApply, so this is called first
+//! thing at start up, before anything depends on the clock.  The governor
+//! starts in automatic mode.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GovernorInit(tGovernor *psGovernor, const tClockProfile *psProfiles,
+             uint32_t ui32Count, uint32_t ui32Low, uint32_t ui32High,
+             uint32_t ui32IdleMs, tGovernorApply *pfnApply)
+{
+    uint32_t ui32Profile;
+
+    psGovernor->psProfiles = psProfiles;
+    psGovernor->ui32Count = ui32Count;
+    psGovernor->ui32Low = ui32Low;
+    psGovernor->ui32High = ui32High;
+    psGovernor->ui32IdleUs = ui32IdleMs * 1000;
+    psGovernor->pfnApply = pfnApply;
+    psGovernor->bAuto = true;
+    psGovernor->ui32Active = 0;
+    psGovernor->ui32Switches = 0;
+    psGovernor->ui64Since = 0;
+
+    for(ui32Profile = 0; ui32Profile < GOVERNOR_PROFILES; ui32Profile++)
+    {
+        psGovernor->pui64Us[ui32Profile] = 0;
+    }
+
+    SysCtlClockSet(psProfiles[ui32High].ui32Config);
+    psGovernor->ui32Current = ui32High;
+}
+
+//*****************************************************************************
+//
+//! Fixes the clock at one profile.
+//!
+//! \param psGovernor is the governor.
+//! \param ui32Profile is the profile.
+//!
+//! The governor stops choosing until GovernorAuto() is called.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GovernorSet(tGovernor *psGovernor, uint32_t ui32Profile)
+{
+    if(ui32Profile >= psGovernor->ui32Count)
+    {
+        return;
+    }
+
+    psGovernor->bAuto = false;
+    GovernorSwitch(psGovernor, ui32Profile);
+}
+
+//*****************************************************************************
+//
+//! Lets the governor choose the clock again.
+//!
+//! \param psGovernor is the governor.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GovernorAuto(tGovernor *psGovernor)
+{
+    psGovernor->bAuto = true;
+    GovernorActivity(psGovernor);
+}
+
+//*****************************************************************************
+//
+//! Reports activity, raising the clock if the governor has lowered it.
+//!
+//! \param psGovernor is the governor.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GovernorActivity(tGovernor *psGovernor)
+{
+    psGovernor->ui32Active = ClockUs();
+
+    if(psGovernor->bAuto)
+    {
+        GovernorSwitch(psGovernor, psGovernor->ui32High);
+    }
+}
+
+//*****************************************************************************
+//
+//! Tells whether the governor is due to lower the clock.
+//!
+//! \param psGovernor is the governor.
+//!
+//! This may be called from an interrupt handler.
+//!
+//! \return Returns \b true if GovernorIdle() would lower the clock.
+//
+//*****************************************************************************
+bool
+GovernorIdleDue(tGovernor *psGovernor)
+{
+    return(psGovernor->bAuto &&
+           (psGovernor->ui32Current != psGovernor->ui32Low) &&
+           ((int32_t)(ClockUs() - psGovernor->ui32Active -
+                      psGovernor->ui32IdleUs) >= 0));
+}
+
+//*****************************************************************************
+//
+//! Lowers the clock if there has been no activity for the idle time.
+//!
+//! \param psGovernor is the governor.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GovernorIdle(tGovernor *psGovernor)
+{
+    if(GovernorIdleDue(psGovernor))
+    {
+        GovernorSwitch(psGovernor, psGovernor->ui32Low);
+    }
+}
+
+//*****************************************************************************
+//
+//! Returns the time spent in a profile.
+//!
+//! \param psGovernor is the governor.
+//! \param ui32Profile is the profile.
+//!
+//! \return Returns the time in microseconds since the governor was set up.
+//
+//*****************************************************************************
+uint64_t
+GovernorResidency(tGovernor *psGovernor, uint32_t ui32Profile)
+{
+    uint64_t ui64Us;
+
+    ui64Us = psGovernor->pui64Us[ui32Profile];
+    if(ui32Profile == psGovernor->ui32Current)
+    {
+        ui64Us += ClockUs64() - psGovernor->ui64Since;
+    }
+
+    return(ui64Us);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,109 @@
+//*****************************************************************************
+//
+// governor.h - Prototypes for the system clock profiles and governor.
+//
+//*****************************************************************************
+
+#ifndef __GOVERNOR_H__
+#define __GOVERNOR_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The most clock profiles a governor can choose from.
+//
+//*****************************************************************************
+#define GOVERNOR_PROFILES       4
+
+//*****************************************************************************
+//
+// A clock profile: a name for the console and the SysCtlClockSet()
+// configuration that selects it.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcName;
+    uint32_t ui32Config;
+}
+tClockProfile;
+
+//*****************************************************************************
+//
+// Called with interrupts masked after each switch, with the system clock
+// before and after, to bring whatever counts in system clock cycles up to
+// date.
+//
+//*****************************************************************************
+typedef void (tGovernorApply)(uint32_t ui32OldHz, uint32_t ui32NewHz);
+
+//*****************************************************************************
+//
+// A governor.  In automatic mode it runs at the high profile from the first
+// activity and drops to the low profile after ui32IdleUs without any.
+//
+//*****************************************************************************
+typedef struct
+{
+    const tClockProfile *psProfiles;
+    uint32_t ui32Count;
+    uint32_t ui32Low;
+    uint32_t ui32High;
+    uint32_t ui32IdleUs;
+    tGovernorApply *pfnApply;
+
+    //
+    // The profile in use, whether the governor chooses it, and the time of
+    // the last activity from ClockUs().
+    //
+    uint32_t ui32Current;
+    bool bAuto;
+    volatile uint32_t ui32Active;
+
+    //
+    // Switches made, and the time spent in each profile up to the last
+    // switch, in microseconds.
+    //
+    uint32_t ui32Switches;
+    uint64_t ui64Since;
+    uint64_t pui64Us[GOVERNOR_PROFILES];
+}
+tGovernor;
+
+//*****************************************************************************
+//
+// Functions exported from governor.c
+//
+//*****************************************************************************
+extern void GovernorInit(tGovernor *psGovernor,
+                         const tClockProfile *psProfiles, uint32_t ui32Count,
+                         uint32_t ui32Low, uint32_t ui32High,
+                         uint32_t ui32IdleMs, tGovernorApply *pfnApply);
+extern void GovernorSet(tGovernor *psGovernor, uint32_t ui32Profile);
+extern void GovernorAuto(tGovernor *psGovernor);
+extern void GovernorActivity(tGovernor *psGovernor);
+extern bool GovernorIdleDue(tGovernor *psGovernor);
+extern void GovernorIdle(tGovernor *psGovernor);
+extern uint64_t GovernorResidency(tGovernor *psGovernor,
+                                  uint32_t ui32Profile);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GOVERNOR_H__
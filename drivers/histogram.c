@@ -0,0 +1,231 @@
+//*****************************************************************************
+//
+// histogram.c - Log-scale histogram for latencies.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drivers/histogram.h"
+
+//*****************************************************************************
+//
+//! \addtogroup histogram_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Latencies spread over many orders of magnitude, from a fraction of a
+// millisecond for a short command to seconds for a scan or a join, so the
+// bins grow with the value.  Values below HISTOGRAM_SUB_BINS get a bin each.
+// Above that, the position of the top set bit picks a power of two and the
+// HISTOGRAM_SUB_BITS bits below it pick one of its bins.  A bin is found
+// with a count of leading zeros and a shift, with no search and no division,
+// and the relative error of a percentile read from the bins is under 25%.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The position of the top set bit of a non-zero value, from the CLZ
+// instruction on the target.
+//
+//*****************************************************************************
+#if defined(ccs)
+#define HISTOGRAM_CLZ(x)        _norm(x)
+#else
+#define HISTOGRAM_CLZ(x)        __builtin_clz(x)
+#endif
+
+static uint32_t
+HistogramLog2(uint32_t ui32Value)
+{
+    return(31 - HISTOGRAM_CLZ(ui32Value));
+}
+
+//*****************************************************************************
+//
+// The bin of a value.
+//
+//*****************************************************************************
+static uint32_t
+HistogramBin(uint32_t ui32Value)
+{
+    uint32_t ui32Log;
+    uint32_t ui32Bin;
+
+    if(ui32Value < HISTOGRAM_SUB_BINS)
+    {
+        return(ui32Value);
+    }
+
+    ui32Log = HistogramLog2(ui32Value);
+    ui32Bin = ((ui32Log - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS) +
+              ((ui32Value >> (ui32Log - HISTOGRAM_SUB_BITS)) &
+               (HISTOGRAM_SUB_BINS - 1));
+
+    return((ui32Bin < HISTOGRAM_BINS) ? ui32Bin : (HISTOGRAM_BINS - 1));
+}
+
+//*****************************************************************************
+//
+// The greatest value that falls in a bin.
+//
+//*****************************************************************************
+static uint32_t
+HistogramBinTop(uint32_t ui32Bin)
+{
+    uint32_t ui32Shift;
+
+    if(ui32Bin < HISTOGRAM_SUB_BINS)
+    {
+        return(ui32Bin);
+    }
+
+    ui32Shift = (ui32Bin >> HISTOGRAM_SUB_BITS) - 1;
+
+    return((((HISTOGRAM_SUB_BINS + (ui32Bin & (HISTOGRAM_SUB_BINS - 1))) + 1)
+            << ui32Shift) - 1);
+}
+
+//*****************************************************************************
+//
+//! Empties a histogram.
+//!
+//! \param psHistogram is the histogram.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+HistogramClear(tHistogram *psHistogram)
+{
+    uint32_t ui32Bin;
+
+    psHistogram->ui32Count = 0;
+    psHistogram->ui32Min = 0xFFFFFFFF;
+    psHistogram->ui32Max = 0;
+    psHistogram->ui64Total = 0;
+
+    for(ui32Bin = 0; ui32Bin < HISTOGRAM_BINS; ui32Bin++)
+    {
+        psHistogram->pui32Bins[ui32Bin] = 0;
+    }
+}
+
+//*****************************************************************************
+//
+//! Adds a value to a histogram.
+//!
+//! \param psHistogram is the histogram.
+//! \param ui32Value is the value.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+HistogramAdd(tHistogram *psHistogram, uint32_t ui32Value)
+{
+    psHistogram->pui32Bins[HistogramBin(ui32Value)]++;
+    psHistogram->ui32Count++;
+    psHistogram->ui64Total += ui32Value;
+
+    if(ui32Value < psHistogram->ui32Min)
+    {
+        psHistogram->ui32Min = ui32Value;
+    }
+    if(ui32Value > psHistogram->ui32Max)
+    {
+        psHistogram->ui32Max = ui32Value;
+    }
+}
+
+//*****************************************************************************
+//
+//! Returns a percentile of the values in a histogram.
+//!
+//! \param psHistogram is the histogram.
+//! \param ui32PerMille is the percentile in tenths of a percent, so 500 is
+//! the median and 990 the 99th percentile.
+//!
+//! The value returned is the top of the bin the percentile falls in, kept
+//! within the least and greatest values added, so it errs high by less than
+//! a bin's width.
+//!
+//! \return Returns the percentile, or 0 if the histogram is empty.
+//
+//*****************************************************************************
+uint32_t
+HistogramPercentile(tHistogram *psHistogram, uint32_t ui32PerMille)
+{
+    uint32_t ui32Rank;
+    uint32_t ui32Seen;
+    uint32_t ui32Bin;
+    uint32_t ui32Value;
+
+    if(psHistogram->ui32Count == 0)
+    {
+        return(0);
+    }
+
+    //
+    // The rank of the value wanted, counting from one and rounding up.
+    //
+    ui32Rank = (uint32_t)((((uint64_t)psHistogram->ui32Count * ui32PerMille) +
+                           999) / 1000);
+    if(ui32Rank == 0)
+    {
+        ui32Rank = 1;
+    }
+
+    ui32Seen = 0;
+    for(ui32Bin = 0; ui32Bin < HISTOGRAM_BINS - 1; ui32Bin++)
+    {
+        ui32Seen += psHistogram->pui32Bins[ui32Bin];
+        if(ui32Seen >= ui32Rank)
+        {
+            break;
+        }
+    }
+
+    ui32Value = HistogramBinTop(ui32Bin);
+    if((ui32Value > psHistogram->ui32Max) || (ui32Bin == HISTOGRAM_BINS - 1))
+    {
+        ui32Value = psHistogram->ui32Max;
+    }
+    if(ui32Value < psHistogram->ui32Min)
+    {
+        ui32Value = psHistogram->ui32Min;
+    }
+
+    return(ui32Value);
+}
+
+//*****************************************************************************
+//
+//! Returns the mean of the values in a histogram.
+//!
+//! \param psHistogram is the histogram.
+//!
+//! \return Returns the mean, or 0 if the histogram is empty.
+//
+//*****************************************************************************
+uint32_t
+HistogramMean(tHistogram *psHistogram)
+{
+    if(psHistogram->ui32Count == 0)
+    {
+        return(0);
+    }
+
+    return((uint32_t)(psHistogram->ui64Total / psHistogram->ui32Count));
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,68 @@
+//*****************************************************************************
+//
+// histogram.h - Prototypes for the log-scale latency histogram.
+//
+//*****************************************************************************
+
+#ifndef __HISTOGRAM_H__
+#define __HISTOGRAM_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Each power of two is split into HISTOGRAM_SUB_BINS bins, so a bin is at
+// most a quarter of its lower bound wide.  HISTOGRAM_BINS covers values up
+// to 2^26, 67 seconds in microseconds; larger values go in the last bin.
+//
+//*****************************************************************************
+#define HISTOGRAM_SUB_BITS      2
+#define HISTOGRAM_SUB_BINS      (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BINS          100
+
+//*****************************************************************************
+//
+// A histogram.  The exact least and greatest values are kept alongside the
+// bins.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Count;
+    uint32_t ui32Min;
+    uint32_t ui32Max;
+    uint64_t ui64Total;
+    uint32_t pui32Bins[HISTOGRAM_BINS];
+}
+tHistogram;
+
+//*****************************************************************************
+//
+// Functions exported from histogram.c
+//
+//*****************************************************************************
+extern void HistogramClear(tHistogram *psHistogram);
+extern void HistogramAdd(tHistogram *psHistogram, uint32_t ui32Value);
+extern uint32_t HistogramPercentile(tHistogram *psHistogram,
+                                    uint32_t ui32PerMille);
+extern uint32_t HistogramMean(tHistogram *psHistogram);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __HISTOGRAM_H__
@@ -0,0 +1,326 @@
+//*****************************************************************************
+//
+// link_mux.c - Per-link send queues and receive buffers for AT+CIPMUX=1.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drivers/ringbuf.h"
+#include "drivers/link_mux.h"
+
+//*****************************************************************************
+//
+//! \addtogroup link_mux_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// In multiple connection mode the module keeps up to five TCP links open at
+// once but still has a single UART, so every link shares the one AT+CIPSEND
+// at a time the module accepts.  Each link queues its outgoing data in a ring
+// of its own; LinkMuxNext() visits the links in turn and offers at most a
+// quantum from each, so a link with a lot queued cannot hold the others off
+// for more than one send.  Received +IPD payloads are sorted into a receive
+// ring per link by their link ID.
+//
+// Like the coalescing buffer this only stores and counts.  Issuing the sends
+// and feeding in the payloads is left to the caller.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Initializes the links, all closed.
+//!
+//! \param psMux is the link set to initialize.
+//! \param pui8TxBuf is the storage for the send queues,
+//! \b LINK_MUX_LINKS times \e ui32Size bytes.
+//! \param pui8RxBuf is the storage for the receive buffers, the same size.
+//! \param ui32Size is the size of each link's queue and of its buffer, which
+//! must be a power of two.
+//! \param ui32Quantum is the most bytes offered from one link in a turn, at
+//! most the largest AT+CIPSEND.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+LinkMuxInit(tLinkMux *psMux, uint8_t *pui8TxBuf, uint8_t *pui8RxBuf,
+            uint32_t ui32Size, uint32_t ui32Quantum)
+{
+    uint32_t ui32Link;
+
+    for(ui32Link = 0; ui32Link < LINK_MUX_LINKS; ui32Link++)
+    {
+        RingBufInit(&psMux->psLinks[ui32Link].sTx,
+                    pui8TxBuf + (ui32Link * ui32Size), ui32Size);
+        RingBufInit(&psMux->psLinks[ui32Link].sRx,
+                    pui8RxBuf + (ui32Link * ui32Size), ui32Size);
+        psMux->psLinks[ui32Link].bOpen = false;
+    }
+
+    psMux->ui32Next = 0;
+    psMux->ui32Quantum = ui32Quantum;
+}
+
+//*****************************************************************************
+//
+//! Marks a link open, as on "<link>,CONNECT".
+//!
+//! \param psMux is the link set.
+//! \param ui32Link is the link ID.
+//!
+//! The link's queues start empty and its counters at zero.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+LinkMuxOpened(tLinkMux *psMux, uint32_t ui32Link)
+{
+    tLink *psLink;
+
+    if(ui32Link >= LINK_MUX_LINKS)
+    {
+        return;
+    }
+
+    psLink = &psMux->psLinks[ui32Link];
+    RingBufInit(&psLink->sTx, psLink->sTx.pui8Buf, psLink->sTx.ui32Size);
+    RingBufInit(&psLink->sRx, psLink->sRx.pui8Buf, psLink->sRx.ui32Size);
+    psLink->ui32Sends = 0;
+    psLink->ui32TxBytes = 0;
+    psLink->ui32RxBytes = 0;
+    psLink->bOpen = true;
+}
+
+//*****************************************************************************
+//
+//! Marks a link closed, as on "<link>,CLOSED".
+//!
+//! \param psMux is the link set.
+//! \param ui32Link is the link ID.
+//!
+//! Data still queued for the link is dropped.  Received data stays readable
+//! until the link is opened again.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+LinkMuxClosed(tLinkMux *psMux, uint32_t ui32Link)
+{
+    tLink *psLink;
+
+    if(ui32Link >= LINK_MUX_LINKS)
+    {
+        return;
+    }
+
+    psLink = &psMux->psLinks[ui32Link];
+    psLink->bOpen = false;
+    RingBufAdvance(&psLink->sTx, RingBufUsed(&psLink->sTx));
+}
+
+//*****************************************************************************
+//
+//! Checks whether a link is open.
+//!
+//! \param psMux is the link set.
+//! \param ui32Link is the link ID.
+//!
+//! \return Returns \b true if the link is open.
+//
+//*****************************************************************************
+bool
+LinkMuxIsOpen(tLinkMux *psMux, uint32_t ui32Link)
+{
+    return((ui32Link < LINK_MUX_LINKS) && psMux->psLinks[ui32Link].bOpen);
+}
+
+//*****************************************************************************
+//
+//! Finds a link ID that is not in use.
+//!
+//! \param psMux is the link set.
+//!
+//! \return Returns the lowest closed link ID, or \b LINK_MUX_NONE.
+//
+//*****************************************************************************
+uint32_t
+LinkMuxFree(tLinkMux *psMux)
+{
+    uint32_t ui32Link;
+
+    for(ui32Link = 0; ui32Link < LINK_MUX_LINKS; ui32Link++)
+    {
+        if(!psMux->psLinks[ui32Link].bOpen)
+        {
+            return(ui32Link);
+        }
+    }
+
+    return(LINK_MUX_NONE);
+}
+
+//*****************************************************************************
+//
+//! Queues data to be sent on a link.
+//!
+//! \param psMux is the link set.
+//! \param ui32Link is the link ID.
+//! \param pui8Data points to the data.
+//! \param ui32Count is the number of bytes.
+//!
+//! The data is queued whole or not at all, so a message is never cut short.
+//!
+//! \return Returns \b true if the data was queued, \b false if the link is
+//! not open or its queue has no room.
+//
+//*****************************************************************************
+bool
+LinkMuxQueue(tLinkMux *psMux, uint32_t ui32Link, const uint8_t *pui8Data,
+             uint32_t ui32Count)
+{
+    tLink *psLink;
+
+    if(!LinkMuxIsOpen(psMux, ui32Link))
+    {
+        return(false);
+    }
+
+    psLink = &psMux->psLinks[ui32Link];
+
+    if(RingBufFree(&psLink->sTx) < ui32Count)
+    {
+        return(false);
+    }
+
+    RingBufWrite(&psLink->sTx, pui8Data, ui32Count);
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Stores data received on a link.
+//!
+//! \param psMux is the link set.
+//! \param ui32Link is the link ID from the +IPD header.
+//! \param pui8Data points to the data.
+//! \param ui32Count is the number of bytes.
+//!
+//! Data for a link ID that is not open is discarded.
+//!
+//! \return Returns the number of bytes taken, which is less than
+//! \e ui32Count when the link's receive buffer is full.
+//
+//*****************************************************************************
+uint32_t
+LinkMuxReceive(tLinkMux *psMux, uint32_t ui32Link, const uint8_t *pui8Data,
+               uint32_t ui32Count)
+{
+    tLink *psLink;
+
+    if(!LinkMuxIsOpen(psMux, ui32Link))
+    {
+        return(ui32Count);
+    }
+
+    psLink = &psMux->psLinks[ui32Link];
+    ui32Count = RingBufWrite(&psLink->sRx, pui8Data, ui32Count);
+    psLink->ui32RxBytes += ui32Count;
+
+    return(ui32Count);
+}
+
+//*****************************************************************************
+//
+//! Picks the next link to send from.
+//!
+//! \param psMux is the link set.
+//! \param ppui8Data receives a pointer to the data to send.
+//! \param pui32Count receives the number of bytes to send.
+//!
+//! The links are visited round-robin, starting after the one that sent last.
+//! The data stays queued until LinkMuxSent() is called, and no other link is
+//! offered until then.
+//!
+//! \return Returns the link ID, or \b LINK_MUX_NONE if nothing is queued.
+//
+//*****************************************************************************
+uint32_t
+LinkMuxNext(tLinkMux *psMux, uint8_t **ppui8Data, uint32_t *pui32Count)
+{
+    uint32_t ui32Turn;
+    uint32_t ui32Link;
+    uint32_t ui32Count;
+
+    for(ui32Turn = 0; ui32Turn < LINK_MUX_LINKS; ui32Turn++)
+    {
+        ui32Link = (psMux->ui32Next + ui32Turn) % LINK_MUX_LINKS;
+
+        if(!psMux->psLinks[ui32Link].bOpen)
+        {
+            continue;
+        }
+
+        ui32Count = RingBufReadSpan(&psMux->psLinks[ui32Link].sTx, ppui8Data);
+        if(ui32Count == 0)
+        {
+            continue;
+        }
+
+        if(ui32Count > psMux->ui32Quantum)
+        {
+            ui32Count = psMux->ui32Quantum;
+        }
+
+        *pui32Count = ui32Count;
+
+        return(ui32Link);
+    }
+
+    return(LINK_MUX_NONE);
+}
+
+//*****************************************************************************
+//
+//! Releases data offered by LinkMuxNext() once it has been sent.
+//!
+//! \param psMux is the link set.
+//! \param ui32Link is the link ID returned by LinkMuxNext().
+//! \param ui32Count is the number of bytes sent, or 0 if the send failed and
+//! the data should be offered again.
+//!
+//! Either way the link's turn is over.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+LinkMuxSent(tLinkMux *psMux, uint32_t ui32Link, uint32_t ui32Count)
+{
+    tLink *psLink;
+
+    psLink = &psMux->psLinks[ui32Link];
+
+    if(ui32Count && psLink->bOpen)
+    {
+        RingBufAdvance(&psLink->sTx, ui32Count);
+        psLink->ui32Sends++;
+        psLink->ui32TxBytes += ui32Count;
+    }
+
+    psMux->ui32Next = (ui32Link + 1) % LINK_MUX_LINKS;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
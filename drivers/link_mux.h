@@ -0,0 +1,107 @@
+//*****************************************************************************
+//
+// link_mux.h - Prototypes for the per-link queues used with AT+CIPMUX=1.
+//
+//*****************************************************************************
+
+#ifndef __LINK_MUX_H__
+#define __LINK_MUX_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The number of link IDs the ESP8266 supports in multiple connection mode.
+//
+//*****************************************************************************
+#define LINK_MUX_LINKS          5
+
+//*****************************************************************************
+//
+// Returned in place of a link ID when there is none.
+//
+//*****************************************************************************
+#define LINK_MUX_NONE           0xffffffff
+
+//*****************************************************************************
+//
+// The state of one link: whether it is open, the data waiting to go out on
+// it and the data received on it, plus counters.
+//
+//*****************************************************************************
+typedef struct
+{
+    bool bOpen;
+    tRingBuf sTx;
+    tRingBuf sRx;
+
+    //
+    // Counters since the link was opened.
+    //
+    uint32_t ui32Sends;
+    uint32_t ui32TxBytes;
+    uint32_t ui32RxBytes;
+}
+tLink;
+
+//*****************************************************************************
+//
+// All the links, and where the round-robin send scheduler stands.
+//
+//*****************************************************************************
+typedef struct
+{
+    tLink psLinks[LINK_MUX_LINKS];
+
+    //
+    // The link the scheduler looks at first on its next turn.
+    //
+    uint32_t ui32Next;
+
+    //
+    // The most bytes sent from one link in a turn.
+    //
+    uint32_t ui32Quantum;
+}
+tLinkMux;
+
+//*****************************************************************************
+//
+// Functions exported from link_mux.c
+//
+//*****************************************************************************
+extern void LinkMuxInit(tLinkMux *psMux, uint8_t *pui8TxBuf,
+                        uint8_t *pui8RxBuf, uint32_t ui32Size,
+                        uint32_t ui32Quantum);
+extern void LinkMuxOpened(tLinkMux *psMux, uint32_t ui32Link);
+extern void LinkMuxClosed(tLinkMux *psMux, uint32_t ui32Link);
+extern bool LinkMuxIsOpen(tLinkMux *psMux, uint32_t ui32Link);
+extern uint32_t LinkMuxFree(tLinkMux *psMux);
+extern bool LinkMuxQueue(tLinkMux *psMux, uint32_t ui32Link,
+                         const uint8_t *pui8Data, uint32_t ui32Count);
+extern uint32_t LinkMuxReceive(tLinkMux *psMux, uint32_t ui32Link,
+                               const uint8_t *pui8Data, uint32_t ui32Count);
+extern uint32_t LinkMuxNext(tLinkMux *psMux, uint8_t **ppui8Data,
+                            uint32_t *pui32Count);
+extern void LinkMuxSent(tLinkMux *psMux, uint32_t ui32Link,
+                        uint32_t ui32Count);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LINK_MUX_H__
@@ -0,0 +1,154 @@
+//*****************************************************************************
+//
+// profile.c - Cycle count profiling with the DWT counter.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "drivers/profile.h"
+
+//*****************************************************************************
+//
+//! \addtogroup profile_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The DWT cycle counter counts processor clocks and wraps every 2^32, so a
+// single piece of code can be measured for up to 268 seconds at 16 MHz
+// without any care for the wrap.  Each profiled piece keeps its call count
+// and its least, greatest and total cycles in a tProfile.
+//
+// A probe records from interrupt handlers and the main loop alike.  The
+// interrupts here all run at the same priority and so never nest; a main
+// loop function that is interrupted is charged for the handler's cycles too,
+// which its maximum shows.
+//
+// What a probe pair costs on its own is measured once at start up and taken
+// off every recording, so an empty probe pair records zero.
+//
+//*****************************************************************************
+static uint32_t g_ui32ProfileOverhead;
+
+//*****************************************************************************
+//
+//! Starts the cycle counter.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ProfileInit(void)
+{
+    uint32_t ui32Start;
+    uint32_t ui32Cycles;
+    uint32_t ui32Pass;
+
+    HWREG(PROFILE_DEMCR) |= PROFILE_DEMCR_TRCENA;
+    HWREG(PROFILE_DWT_CYCCNT) = 0;
+    HWREG(PROFILE_DWT_CTRL) |= PROFILE_DWT_CYCCNTENA;
+
+    //
+    // The least of a few tries, so an interrupt cannot inflate it.
+    //
+    g_ui32ProfileOverhead = 0xFFFFFFFF;
+    for(ui32Pass = 0; ui32Pass < 8; ui32Pass++)
+    {
+        ui32Start = ProfileCycles();
+        ui32Cycles = ProfileCycles() - ui32Start;
+        if(ui32Cycles < g_ui32ProfileOverhead)
+        {
+            g_ui32ProfileOverhead = ui32Cycles;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Returns the cycles taken off each recording for the probes themselves.
+//!
+//! \return Returns the number of cycles.
+//
+//*****************************************************************************
+uint32_t
+ProfileOverhead(void)
+{
+    return(g_ui32ProfileOverhead);
+}
+
+//*****************************************************************************
+//
+//! Records one run of profiled code.
+//!
+//! \param psProfile is the profile to record in.
+//! \param ui32Start is the cycle count taken when the code started.
+//!
+//! Called through PROFILE_END().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ProfileRecord(tProfile *psProfile, uint32_t ui32Start)
+{
+    uint32_t ui32Cycles;
+
+    ui32Cycles = ProfileCycles() - ui32Start;
+    ui32Cycles = (ui32Cycles > g_ui32ProfileOverhead) ?
+                 (ui32Cycles - g_ui32ProfileOverhead) : 0;
+
+    psProfile->ui32Count++;
+    psProfile->ui64Total += ui32Cycles;
+    if(ui32Cycles < psProfile->ui32Min)
+    {
+        psProfile->ui32Min = ui32Cycles;
+    }
+    if(ui32Cycles > psProfile->ui32Max)
+    {
+        psProfile->ui32Max = ui32Cycles;
+    }
+}
+
+//*****************************************************************************
+//
+//! Copies a profile and starts it again from nothing.
+//!
+//! \param psProfile is the profile.
+//! \param psCopy is filled with what it held.
+//!
+//! Interrupts are masked meanwhile, so a handler cannot record into the
+//! profile halfway through.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ProfileTake(tProfile *psProfile, tProfile *psCopy)
+{
+    bool bMasked;
+
+    bMasked = IntMasterDisable();
+
+    *psCopy = *psProfile;
+    psProfile->ui32Count = 0;
+    psProfile->ui32Min = 0xFFFFFFFF;
+    psProfile->ui32Max = 0;
+    psProfile->ui64Total = 0;
+
+    if(!bMasked)
+    {
+        IntMasterEnable();
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
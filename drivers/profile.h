@@ -0,0 +1,100 @@
+//*****************************************************************************
+//
+// profile.h - Prototypes for cycle count profiling with the DWT counter.
+//
+//*****************************************************************************
+
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Set PROFILE_ENABLE to 0 to compile the probes out.  Each probe pair costs
+// about a dozen cycles, which is subtracted from what it records.
+//
+//*****************************************************************************
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE          1
+#endif
+
+//*****************************************************************************
+//
+// The Cortex-M4 data watchpoint and trace unit's cycle counter, and the
+// debug register bit that powers the unit.  Reading the counter needs
+// inc/hw_types.h.
+//
+//*****************************************************************************
+#define PROFILE_DWT_CTRL        0xE0001000
+#define PROFILE_DWT_CYCCNT      0xE0001004
+#define PROFILE_DEMCR           0xE000EDFC
+#define PROFILE_DWT_CYCCNTENA   0x00000001
+#define PROFILE_DEMCR_TRCENA    0x01000000
+
+#define ProfileCycles()         HWREG(PROFILE_DWT_CYCCNT)
+
+//*****************************************************************************
+//
+// The cycle counts of one profiled piece of code.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcName;
+    uint32_t ui32Count;
+    uint32_t ui32Min;
+    uint32_t ui32Max;
+    uint64_t ui64Total;
+}
+tProfile;
+
+#define PROFILE_INIT(pcName)    { (pcName), 0, 0xFFFFFFFF, 0, 0 }
+
+//*****************************************************************************
+//
+// Probes.  PROFILE_START() takes the count into a local variable at the top
+// of the code measured, and PROFILE_END() records the cycles since then.
+//
+//*****************************************************************************
+#if PROFILE_ENABLE
+#define PROFILE_START(ui32Start)                                              \
+        ((ui32Start) = ProfileCycles())
+#define PROFILE_END(psProfile, ui32Start)                                     \
+        ProfileRecord((psProfile), (ui32Start))
+#else
+#define PROFILE_START(ui32Start)                                              \
+        ((void)(ui32Start))
+#define PROFILE_END(psProfile, ui32Start)                                     \
+        ((void)(ui32Start))
+#endif
+
+//*****************************************************************************
+//
+// Functions exported from profile.c
+//
+//*****************************************************************************
+extern void ProfileInit(void);
+extern uint32_t ProfileOverhead(void);
+extern void ProfileRecord(tProfile *psProfile, uint32_t ui32Start);
+extern void ProfileTake(tProfile *psProfile, tProfile *psCopy);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PROFILE_H__
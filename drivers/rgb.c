@@ -64,6 +64,15 @@
 static uint32_t  g_ui32Colors[3];
 static float g_fIntensity = 0.3f;
 
+//*****************************************************************************
+//
+// Cycle counts of the blink interrupt and of the color update, which does
+// floating point math for each channel.
+//
+//*****************************************************************************
+tProfile g_sRGBBlinkProfile = PROFILE_INIT("RGBBlinkIntHandler");
+tProfile g_sRGBColorSetProfile = PROFILE_INIT("RGBColorSet");
+
 //*****************************************************************************
 //
 //! Wide Timer interrupt to handle blinking effect of the RGB 
@@ -83,7 +92,9 @@ void
 RGBBlinkIntHandler(void)
 {
     static unsigned long ulFlags;
+    uint32_t ui32Start;
 
+    PROFILE_START(ui32Start);
 
     //
     // Clear the timer interrupt.
@@ -104,6 +115,7 @@ RGBBlinkIntHandler(void)
         RGBDisable();
     }
 
+    PROFILE_END(&g_sRGBBlinkProfile, ui32Start);
 }
 
 //*****************************************************************************
@@ -290,6 +302,9 @@ RGBColorSet(volatile uint32_t * pui32RGBColor)
 {
     uint32_t ui32Color[3];
     uint32_t ui32Index;
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
 
     for(ui32Index=0; ui32Index < 3; ui32Index++)
     {
@@ -306,6 +321,8 @@ RGBColorSet(volatile uint32_t * pui32RGBColor)
     ROM_TimerMatchSet(RED_TIMER_BASE, RED_TIMER, ui32Color[RED]);
     ROM_TimerMatchSet(GREEN_TIMER_BASE, GREEN_TIMER, ui32Color[GREEN]);
     ROM_TimerMatchSet(BLUE_TIMER_BASE, BLUE_TIMER, ui32Color[BLUE]);
+
+    PROFILE_END(&g_sRGBColorSetProfile, ui32Start);
 }
 
 //*****************************************************************************
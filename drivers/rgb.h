@@ -25,6 +25,8 @@
 #ifndef __RGBLED_H__
 #define __RGBLED_H__
 
+#include "drivers/profile.h"
+
 //*****************************************************************************
 //
 // Defines for the hardware resources used by the pushbuttons.
@@ -126,17 +128,19 @@ extern void RGBGet(uint32_t * pui32RGBColor, float * pfIntensity);
 
 //*****************************************************************************
 //
-// Mark the end of the C bindings section for C++ compilers.
+// Prototypes for the globals exported by this driver.
 //
 //*****************************************************************************
-#ifdef __cplusplus
-}
-#endif
+extern tProfile g_sRGBBlinkProfile;
+extern tProfile g_sRGBColorSetProfile;
 
 //*****************************************************************************
 //
-// Prototypes for the globals exported by this driver.
+// Mark the end of the C bindings section for C++ compilers.
 //
 //*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
 
 #endif // __RGBLED_H__
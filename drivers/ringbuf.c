@@ -0,0 +1,283 @@
+//*****************************************************************************
+//
+// ringbuf.c - Lock-free single producer/single consumer byte ring.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drivers/ringbuf.h"
+
+//*****************************************************************************
+//
+//! \addtogroup ringbuf_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Initializes a ring.
+//!
+//! \param psRing is the ring to initialize.
+//! \param pui8Buf is the storage for the ring.
+//! \param ui32Size is the size of \e pui8Buf, which must be a power of two.
+//!
+//! This must be called before either side starts using the ring.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+RingBufInit(tRingBuf *psRing, uint8_t *pui8Buf, uint32_t ui32Size)
+{
+    psRing->ui32Write = 0;
+    psRing->ui32Read = 0;
+    psRing->ui32Dropped = 0;
+    psRing->pui8Buf = pui8Buf;
+    psRing->ui32Size = ui32Size;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of bytes waiting in the ring.
+//!
+//! \param psRing is the ring.
+//!
+//! May be called from either side.  The producer may see a value that is too
+//! large and the consumer one that is too small, never the other way round.
+//!
+//! \return Returns the number of bytes that can be read.
+//
+//*****************************************************************************
+uint32_t
+RingBufUsed(tRingBuf *psRing)
+{
+    return(psRing->ui32Write - psRing->ui32Read);
+}
+
+//*****************************************************************************
+//
+//! Returns the free space in the ring.
+//!
+//! \param psRing is the ring.
+//!
+//! \return Returns the number of bytes that can be written.
+//
+//*****************************************************************************
+uint32_t
+RingBufFree(tRingBuf *psRing)
+{
+    return(psRing->ui32Size - (psRing->ui32Write - psRing->ui32Read));
+}
+
+//*****************************************************************************
+//
+//! Writes one byte into the ring.  Producer side only.
+//!
+//! \param psRing is the ring.
+//! \param ui8Data is the byte to write.
+//!
+//! If the ring is full the byte is dropped and counted in ui32Dropped.
+//!
+//! \return Returns \b true if the byte was written.
+//
+//*****************************************************************************
+bool
+RingBufPut(tRingBuf *psRing, uint8_t ui8Data)
+{
+    uint32_t ui32Write;
+
+    ui32Write = psRing->ui32Write;
+
+    if((ui32Write - psRing->ui32Read) >= psRing->ui32Size)
+    {
+        psRing->ui32Dropped++;
+        return(false);
+    }
+
+    psRing->pui8Buf[ui32Write & (psRing->ui32Size - 1)] = ui8Data;
+
+    //
+    // The byte must be in memory before the consumer can see the new index.
+    //
+    RING_BARRIER();
+    psRing->ui32Write = ui32Write + 1;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Reads one byte from the ring.  Consumer side only.
+//!
+//! \param psRing is the ring.
+//! \param pui8Data receives the byte.
+//!
+//! \return Returns \b true if a byte was read, \b false if the ring is empty.
+//
+//*****************************************************************************
+bool
+RingBufGet(tRingBuf *psRing, uint8_t *pui8Data)
+{
+    uint32_t ui32Read;
+
+    ui32Read = psRing->ui32Read;
+
+    if(ui32Read == psRing->ui32Write)
+    {
+        return(false);
+    }
+
+    //
+    // Do not read the slot before the index that published it, and do not
+    // hand the slot back before it has been read.
+    //
+    RING_BARRIER();
+    *pui8Data = psRing->pui8Buf[ui32Read & (psRing->ui32Size - 1)];
+    RING_BARRIER();
+    psRing->ui32Read = ui32Read + 1;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Writes as many bytes as fit into the ring.  Producer side only.
+//!
+//! \param psRing is the ring.
+//! \param pui8Data points to the bytes to write.
+//! \param ui32Count is the number of bytes to write.
+//!
+//! Unlike RingBufPut(), bytes that do not fit are not counted as dropped; the
+//! caller is expected to retry with the remainder.
+//!
+//! \return Returns the number of bytes written.
+//
+//*****************************************************************************
+uint32_t
+RingBufWrite(tRingBuf *psRing, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    uint32_t ui32Write;
+    uint32_t ui32Free;
+    uint32_t ui32Index;
+
+    ui32Write = psRing->ui32Write;
+    ui32Free = psRing->ui32Size - (ui32Write - psRing->ui32Read);
+
+    if(ui32Count > ui32Free)
+    {
+        ui32Count = ui32Free;
+    }
+
+    for(ui32Index = 0; ui32Index < ui32Count; ui32Index++)
+    {
+        psRing->pui8Buf[(ui32Write + ui32Index) & (psRing->ui32Size - 1)] =
+            pui8Data[ui32Index];
+    }
+
+    RING_BARRIER();
+    psRing->ui32Write = ui32Write + ui32Count;
+
+    return(ui32Count);
+}
+
+//*****************************************************************************
+//
+//! Reads up to \e ui32Count bytes from the ring.  Consumer side only.
+//!
+//! \param psRing is the ring.
+//! \param pui8Data receives the bytes.
+//! \param ui32Count is the maximum number of bytes to read.
+//!
+//! \return Returns the number of bytes read.
+//
+//*****************************************************************************
+uint32_t
+RingBufRead(tRingBuf *psRing, uint8_t *pui8Data, uint32_t ui32Count)
+{
+    uint32_t ui32Read;
+    uint32_t ui32Used;
+    uint32_t ui32Index;
+
+    ui32Read = psRing->ui32Read;
+    ui32Used = psRing->ui32Write - ui32Read;
+
+    if(ui32Count > ui32Used)
+    {
+        ui32Count = ui32Used;
+    }
+
+    RING_BARRIER();
+
+    for(ui32Index = 0; ui32Index < ui32Count; ui32Index++)
+    {
+        pui8Data[ui32Index] =
+            psRing->pui8Buf[(ui32Read + ui32Index) & (psRing->ui32Size - 1)];
+    }
+
+    RING_BARRIER();
+    psRing->ui32Read = ui32Read + ui32Count;
+
+    return(ui32Count);
+}
+
+//*****************************************************************************
+//
+//! Returns the longest run of waiting bytes that is contiguous in memory.
+//! Consumer side only.
+//!
+//! \param psRing is the ring.
+//! \param ppui8Data receives a pointer to the first waiting byte.
+//!
+//! This lets the consumer hand the bytes to a DMA channel without copying
+//! them.  The bytes stay owned by the consumer until RingBufAdvance() is
+//! called.
+//!
+//! \return Returns the number of contiguous bytes at \e *ppui8Data.
+//
+//*****************************************************************************
+uint32_t
+RingBufReadSpan(tRingBuf *psRing, uint8_t **ppui8Data)
+{
+    uint32_t ui32Offset;
+    uint32_t ui32Used;
+
+    ui32Offset = psRing->ui32Read & (psRing->ui32Size - 1);
+    ui32Used = psRing->ui32Write - psRing->ui32Read;
+
+    RING_BARRIER();
+
+    *ppui8Data = psRing->pui8Buf + ui32Offset;
+
+    if(ui32Used > (psRing->ui32Size - ui32Offset))
+    {
+        ui32Used = psRing->ui32Size - ui32Offset;
+    }
+
+    return(ui32Used);
+}
+
+//*****************************************************************************
+//
+//! Releases bytes returned by RingBufReadSpan().  Consumer side only.
+//!
+//! \param psRing is the ring.
+//! \param ui32Count is the number of bytes consumed.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+RingBufAdvance(tRingBuf *psRing, uint32_t ui32Count)
+{
+    RING_BARRIER();
+    psRing->ui32Read += ui32Count;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
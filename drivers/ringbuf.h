@@ -0,0 +1,84 @@
+//*****************************************************************************
+//
+// ringbuf.h - Prototypes for the lock-free single producer/consumer ring.
+//
+//*****************************************************************************
+
+#ifndef __RINGBUF_H__
+#define __RINGBUF_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Memory barrier used to order the buffer contents against the index that
+// publishes them.  On the single core Cortex-M4 a DMB is enough; on the host
+// build the compiler's full barrier is used instead.
+//
+//*****************************************************************************
+#if defined(ccs)
+#define RING_BARRIER()          __asm("    dmb")
+#elif defined(__arm__)
+#define RING_BARRIER()          __asm volatile("dmb" : : : "memory")
+#else
+#define RING_BARRIER()          __sync_synchronize()
+#endif
+
+//*****************************************************************************
+//
+// A byte ring shared by exactly one producer and one consumer, typically an
+// interrupt handler on one side and the main loop on the other.  The indices
+// run freely and are only reduced modulo the size when the buffer is
+// accessed, so a full ring and an empty ring are told apart without wasting
+// a slot.  The size must be a power of two.
+//
+// Only the producer writes ui32Write and ui32Dropped; only the consumer
+// writes ui32Read.
+//
+//*****************************************************************************
+typedef struct
+{
+    volatile uint32_t ui32Write;
+    volatile uint32_t ui32Read;
+    volatile uint32_t ui32Dropped;
+    uint8_t *pui8Buf;
+    uint32_t ui32Size;
+}
+tRingBuf;
+
+//*****************************************************************************
+//
+// Functions exported from ringbuf.c
+//
+//*****************************************************************************
+extern void RingBufInit(tRingBuf *psRing, uint8_t *pui8Buf, uint32_t ui32Size);
+extern uint32_t RingBufUsed(tRingBuf *psRing);
+extern uint32_t RingBufFree(tRingBuf *psRing);
+extern bool RingBufPut(tRingBuf *psRing, uint8_t ui8Data);
+extern bool RingBufGet(tRingBuf *psRing, uint8_t *pui8Data);
+extern uint32_t RingBufWrite(tRingBuf *psRing, const uint8_t *pui8Data,
+                             uint32_t ui32Count);
+extern uint32_t RingBufRead(tRingBuf *psRing, uint8_t *pui8Data,
+                            uint32_t ui32Count);
+extern uint32_t RingBufReadSpan(tRingBuf *psRing, uint8_t **ppui8Data);
+extern void RingBufAdvance(tRingBuf *psRing, uint32_t ui32Count);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __RINGBUF_H__
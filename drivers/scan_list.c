@@ -0,0 +1,375 @@
+//*****************************************************************************
+//
+// scan_list.c - The list of access points found by a scan.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "drivers/scan_list.h"
+
+//*****************************************************************************
+//
+//! \addtogroup scan_list_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Each +CWLAP line is parsed as soon as the parser has it, into a record of
+// a few dozen bytes, so only one line of text is ever held.  The line looks
+// like
+//
+//     +CWLAP:(3,"home",-45,"aa:bb:cc:dd:ee:ff",6,-12,0)
+//
+// with the encryption, SSID, RSSI, BSSID and channel first; anything after
+// the channel is ignored, and so is a line cut short after the SSID, as
+// AT+CWLAPOPT can ask for.  An SSID may hold commas and quotes, so it ends
+// at the first quote that is followed by a comma and a number.
+//
+// The list is kept in order of RSSI by insertion, and an SSID seen twice,
+// from two access points of one network, keeps only its strongest.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Parses a decimal number, with an optional minus sign, and moves past it.
+//
+//*****************************************************************************
+static bool
+ScanListNumber(const char **ppcText, int32_t *pi32Value)
+{
+    const char *pcText;
+    bool bNegative;
+    int32_t i32Value;
+
+    pcText = *ppcText;
+    bNegative = (*pcText == '-');
+    if(bNegative)
+    {
+        pcText++;
+    }
+
+    if((*pcText < '0') || (*pcText > '9'))
+    {
+        return(false);
+    }
+
+    for(i32Value = 0; (*pcText >= '0') && (*pcText <= '9'); pcText++)
+    {
+        i32Value = (i32Value * 10) + (*pcText - '0');
+    }
+
+    *pi32Value = bNegative ? -i32Value : i32Value;
+    *ppcText = pcText;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// The value of a hexadecimal digit, or -1.
+//
+//*****************************************************************************
+static int32_t
+ScanListHex(char cChar)
+{
+    if((cChar >= '0') && (cChar <= '9'))
+    {
+        return(cChar - '0');
+    }
+    if((cChar >= 'a') && (cChar <= 'f'))
+    {
+        return(cChar - 'a' + 10);
+    }
+    if((cChar >= 'A') && (cChar <= 'F'))
+    {
+        return(cChar - 'A' + 10);
+    }
+
+    return(-1);
+}
+
+//*****************************************************************************
+//
+// Parses a quoted BSSID, "aa:bb:cc:dd:ee:ff", and moves past it.
+//
+//*****************************************************************************
+static bool
+ScanListBSSID(const char **ppcText, uint8_t *pui8BSSID)
+{
+    const char *pcText;
+    uint32_t ui32Byte;
+    int32_t i32High;
+    int32_t i32Low;
+
+    pcText = *ppcText;
+    if(*pcText++ != '"')
+    {
+        return(false);
+    }
+
+    for(ui32Byte = 0; ui32Byte < 6; ui32Byte++)
+    {
+        i32High = ScanListHex(pcText[0]);
+        i32Low = (i32High < 0) ? -1 : ScanListHex(pcText[1]);
+        if(i32Low < 0)
+        {
+            return(false);
+        }
+
+        pui8BSSID[ui32Byte] = (uint8_t)((i32High << 4) | i32Low);
+        pcText += 2;
+
+        if(*pcText++ != ((ui32Byte == 5) ? '"' : ':'))
+        {
+            return(false);
+        }
+    }
+
+    *ppcText = pcText;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Empties a scan list.
+//!
+//! \param psList is the list.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+ScanListClear(tScanList *psList)
+{
+    psList->ui32Count = 0;
+    psList->ui32Dropped = 0;
+}
+
+//*****************************************************************************
+//
+//! Parses one +CWLAP line.
+//!
+//! \param pcLine is the line, NUL terminated, without its line ending.
+//! \param psRecord is filled in from it.
+//!
+//! Fields the line leaves out are set to zero.
+//!
+//! \return Returns \b true if the line held an access point with an SSID.
+//
+//*****************************************************************************
+bool
+ScanListParse(const char *pcLine, tScanRecord *psRecord)
+{
+    const char *pcSSID;
+    const char *pcEnd;
+    uint32_t ui32Length;
+    int32_t i32Value;
+
+    memset(psRecord, 0, sizeof(*psRecord));
+
+    if(strncmp(pcLine, "+CWLAP:(", 8) != 0)
+    {
+        return(false);
+    }
+    pcLine += 8;
+
+    //
+    // The encryption.
+    //
+    if(!ScanListNumber(&pcLine, &i32Value) || (pcLine[0] != ',') ||
+       (pcLine[1] != '"'))
+    {
+        return(false);
+    }
+    psRecord->ui8Encryption = (uint8_t)i32Value;
+    pcSSID = pcLine + 2;
+
+    //
+    // The SSID, up to the quote that ends it.  A hidden network has none and
+    // cannot be joined by name.
+    //
+    for(pcEnd = pcSSID; *pcEnd; pcEnd++)
+    {
+        if((pcEnd[0] == '"') &&
+           ((pcEnd[1] == ')') || (pcEnd[1] == '\0') ||
+            ((pcEnd[1] == ',') &&
+             ((pcEnd[2] == '-') || ((pcEnd[2] >= '0') &&
+                                    (pcEnd[2] <= '9'))))))
+        {
+            break;
+        }
+    }
+
+    ui32Length = pcEnd - pcSSID;
+    if((*pcEnd != '"') || (ui32Length == 0) ||
+       (ui32Length > SCAN_LIST_SSID_SIZE))
+    {
+        return(false);
+    }
+    memcpy(psRecord->pcSSID, pcSSID, ui32Length);
+    psRecord->pcSSID[ui32Length] = '\0';
+    pcLine = pcEnd + 1;
+
+    //
+    // The RSSI, BSSID and channel, as far as the line goes.
+    //
+    if(*pcLine++ != ',')
+    {
+        return(true);
+    }
+    if(!ScanListNumber(&pcLine, &i32Value))
+    {
+        return(false);
+    }
+    psRecord->i8RSSI = (int8_t)i32Value;
+
+    if(*pcLine++ != ',')
+    {
+        return(true);
+    }
+    if(!ScanListBSSID(&pcLine, psRecord->pui8BSSID))
+    {
+        return(false);
+    }
+
+    if(*pcLine++ != ',')
+    {
+        return(true);
+    }
+    if(!ScanListNumber(&pcLine, &i32Value))
+    {
+        return(false);
+    }
+    psRecord->ui8Channel = (uint8_t)i32Value;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Adds the access point of a +CWLAP line to a scan list.
+//!
+//! \param psList is the list.
+//! \param pcLine is the line, NUL terminated, without its line ending.
+//!
+//! The access point goes in at its place by RSSI.  If its SSID is on the
+//! list already, the stronger of the two is kept; if the list is full, the
+//! weakest access point is dropped.
+//!
+//! \return Returns \b true if the access point is on the list afterwards.
+//
+//*****************************************************************************
+bool
+ScanListAdd(tScanList *psList, const char *pcLine)
+{
+    tScanRecord sRecord;
+    uint32_t ui32Index;
+    uint32_t ui32Place;
+
+    if(!ScanListParse(pcLine, &sRecord))
+    {
+        psList->ui32Dropped++;
+        return(false);
+    }
+
+    //
+    // Take out a weaker entry for the same SSID, or give up on this one if
+    // the entry is stronger.
+    //
+    for(ui32Index = 0; ui32Index < psList->ui32Count; ui32Index++)
+    {
+        if(strcmp(psList->psRecords[ui32Index].pcSSID, sRecord.pcSSID) == 0)
+        {
+            if(psList->psRecords[ui32Index].i8RSSI >= sRecord.i8RSSI)
+            {
+                return(true);
+            }
+
+            memmove(&psList->psRecords[ui32Index],
+                    &psList->psRecords[ui32Index + 1],
+                    (psList->ui32Count - ui32Index - 1) *
+                    sizeof(tScanRecord));
+            psList->ui32Count--;
+            break;
+        }
+    }
+
+    //
+    // Find its place, after every entry at least as strong.
+    //
+    for(ui32Place = 0; ui32Place < psList->ui32Count; ui32Place++)
+    {
+        if(psList->psRecords[ui32Place].i8RSSI < sRecord.i8RSSI)
+        {
+            break;
+        }
+    }
+
+    if(ui32Place == SCAN_LIST_SIZE)
+    {
+        psList->ui32Dropped++;
+        return(false);
+    }
+
+    if(psList->ui32Count == SCAN_LIST_SIZE)
+    {
+        psList->ui32Count--;
+        psList->ui32Dropped++;
+    }
+
+    memmove(&psList->psRecords[ui32Place + 1], &psList->psRecords[ui32Place],
+            (psList->ui32Count - ui32Place) * sizeof(tScanRecord));
+    psList->psRecords[ui32Place] = sRecord;
+    psList->ui32Count++;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Returns the number of access points on a scan list.
+//!
+//! \param psList is the list.
+//!
+//! \return Returns the number of access points.
+//
+//*****************************************************************************
+uint32_t
+ScanListCount(tScanList *psList)
+{
+    return(psList->ui32Count);
+}
+
+//*****************************************************************************
+//
+//! Returns an access point from a scan list.
+//!
+//! \param psList is the list.
+//! \param ui32Index is its place on the list, 0 for the strongest.
+//!
+//! \return Returns the access point, or 0 if there are not that many.
+//
+//*****************************************************************************
+const tScanRecord *
+ScanListGet(tScanList *psList, uint32_t ui32Index)
+{
+    if(ui32Index >= psList->ui32Count)
+    {
+        return(0);
+    }
+
+    return(&psList->psRecords[ui32Index]);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,92 @@
+//*****************************************************************************
+//
+// scan_list.h - Prototypes for the list of access points found by a scan.
+//
+//*****************************************************************************
+
+#ifndef __SCAN_LIST_H__
+#define __SCAN_LIST_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The most access points kept from one scan, and the longest SSID the
+// 802.11 standard allows.
+//
+//*****************************************************************************
+#define SCAN_LIST_SIZE          32
+#define SCAN_LIST_SSID_SIZE     32
+
+//*****************************************************************************
+//
+// The largest +CWLAP line worth parsing: an SSID of 32 bytes plus the other
+// fields, with room to spare.
+//
+//*****************************************************************************
+#define SCAN_LIST_LINE_SIZE     128
+
+//*****************************************************************************
+//
+// One access point.  ui8Encryption is the ESP8266's number for it, 0 for an
+// open network up to 4 for WPA/WPA2 PSK.
+//
+//*****************************************************************************
+typedef struct
+{
+    char pcSSID[SCAN_LIST_SSID_SIZE + 1];
+    int8_t i8RSSI;
+    uint8_t ui8Channel;
+    uint8_t ui8Encryption;
+    uint8_t pui8BSSID[6];
+}
+tScanRecord;
+
+//*****************************************************************************
+//
+// The access points of a scan, strongest first, each SSID once.
+//
+//*****************************************************************************
+typedef struct
+{
+    tScanRecord psRecords[SCAN_LIST_SIZE];
+    uint32_t ui32Count;
+
+    //
+    // Lines that could not be parsed, or were dropped because the list was
+    // full of stronger access points.
+    //
+    uint32_t ui32Dropped;
+}
+tScanList;
+
+//*****************************************************************************
+//
+// Functions exported from scan_list.c
+//
+//*****************************************************************************
+extern void ScanListClear(tScanList *psList);
+extern bool ScanListParse(const char *pcLine, tScanRecord *psRecord);
+extern bool ScanListAdd(tScanList *psList, const char *pcLine);
+extern uint32_t ScanListCount(tScanList *psList);
+extern const tScanRecord *ScanListGet(tScanList *psList, uint32_t ui32Index);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SCAN_LIST_H__
@@ -0,0 +1,238 @@
+//*****************************************************************************
+//
+// settings.c - The network settings kept in EEPROM.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "driverlib/eeprom.h"
+#include "driverlib/sysctl.h"
+#include "drivers/settings.h"
+
+//*****************************************************************************
+//
+//! \addtogroup settings_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Every word of the EEPROM stands a limited number of writes, so the
+// settings are only written when they change, and each write goes to the
+// next of SETTINGS_SLOTS slots in turn, spreading the wear over all of them.
+// A slot holds a sequence number and a CRC; the newest slot whose CRC is
+// right is the one in use, so a write cut short by a reset leaves the one
+// before it in force.
+//
+//*****************************************************************************
+#define SETTINGS_MAGIC          0x57494649
+
+//*****************************************************************************
+//
+// The slot holding the settings in use and their sequence number, or
+// SETTINGS_SLOTS if there are none.
+//
+//*****************************************************************************
+static uint32_t g_ui32SettingsSlot = SETTINGS_SLOTS;
+static uint32_t g_ui32SettingsSequence;
+static tSettings g_sSettingsStored;
+
+//*****************************************************************************
+//
+// The CRC-32 of the settings up to their check word.
+//
+//*****************************************************************************
+static uint32_t
+SettingsCheck(const tSettings *psSettings)
+{
+    const uint8_t *pui8Data;
+    uint32_t ui32Count;
+    uint32_t ui32CRC;
+    uint32_t ui32Bit;
+
+    pui8Data = (const uint8_t *)psSettings;
+    ui32CRC = 0xFFFFFFFF;
+
+    for(ui32Count = offsetof(tSettings, ui32Check); ui32Count; ui32Count--)
+    {
+        ui32CRC ^= *pui8Data++;
+        for(ui32Bit = 0; ui32Bit < 8; ui32Bit++)
+        {
+            ui32CRC = (ui32CRC >> 1) ^ (0xEDB88320 & -(ui32CRC & 1));
+        }
+    }
+
+    return(~ui32CRC);
+}
+
+//*****************************************************************************
+//
+// Whether two sets of settings hold the same network and server.
+//
+//*****************************************************************************
+static bool
+SettingsSame(const tSettings *psA, const tSettings *psB)
+{
+    return(memcmp(psA->pcSSID, psB->pcSSID,
+                  offsetof(tSettings, ui32Check) -
+                  offsetof(tSettings, pcSSID)) == 0);
+}
+
+//*****************************************************************************
+//
+//! Starts the EEPROM.
+//!
+//! \return Returns \b false if the EEPROM could not be started.
+//
+//*****************************************************************************
+bool
+SettingsInit(void)
+{
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0))
+    {
+    }
+
+    return(EEPROMInit() == EEPROM_INIT_OK);
+}
+
+//*****************************************************************************
+//
+//! Reads the settings in use.
+//!
+//! \param psSettings is filled with the settings.
+//!
+//! \return Returns \b false if no slot holds valid settings, in which case
+//! \e psSettings is cleared.
+//
+//*****************************************************************************
+bool
+SettingsLoad(tSettings *psSettings)
+{
+    uint32_t ui32Slot;
+
+    g_ui32SettingsSlot = SETTINGS_SLOTS;
+    g_ui32SettingsSequence = 0;
+
+    for(ui32Slot = 0; ui32Slot < SETTINGS_SLOTS; ui32Slot++)
+    {
+        EEPROMRead((uint32_t *)psSettings,
+                   SETTINGS_BASE + (ui32Slot * SETTINGS_SLOT_SIZE),
+                   sizeof(tSettings));
+
+        if((psSettings->ui32Magic != SETTINGS_MAGIC) ||
+           (psSettings->ui32Check != SettingsCheck(psSettings)))
+        {
+            continue;
+        }
+
+        if((g_ui32SettingsSlot == SETTINGS_SLOTS) ||
+           ((int32_t)(psSettings->ui32Sequence -
+                      g_ui32SettingsSequence) > 0))
+        {
+            g_ui32SettingsSlot = ui32Slot;
+            g_ui32SettingsSequence = psSettings->ui32Sequence;
+            g_sSettingsStored = *psSettings;
+        }
+    }
+
+    if(g_ui32SettingsSlot == SETTINGS_SLOTS)
+    {
+        memset(psSettings, 0, sizeof(tSettings));
+        memset(&g_sSettingsStored, 0, sizeof(tSettings));
+        return(false);
+    }
+
+    *psSettings = g_sSettingsStored;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Writes settings, if they differ from those in use.
+//!
+//! \param psSettings is the settings.  Their magic number, sequence number
+//! and check word are filled in.
+//!
+//! SettingsLoad() must have been called first.
+//!
+//! \return Returns \b false if the EEPROM could not be written.
+//
+//*****************************************************************************
+bool
+SettingsSave(tSettings *psSettings)
+{
+    uint32_t ui32Slot;
+
+    if((g_ui32SettingsSlot != SETTINGS_SLOTS) &&
+       SettingsSame(psSettings, &g_sSettingsStored))
+    {
+        return(true);
+    }
+
+    ui32Slot = (g_ui32SettingsSlot + 1) % SETTINGS_SLOTS;
+
+    psSettings->ui32Magic = SETTINGS_MAGIC;
+    psSettings->ui32Sequence = g_ui32SettingsSequence + 1;
+    psSettings->ui8Reserved = 0;
+    psSettings->ui32Check = SettingsCheck(psSettings);
+
+    if(EEPROMProgram((uint32_t *)psSettings,
+                     SETTINGS_BASE + (ui32Slot * SETTINGS_SLOT_SIZE),
+                     sizeof(tSettings)) != 0)
+    {
+        return(false);
+    }
+
+    g_ui32SettingsSlot = ui32Slot;
+    g_ui32SettingsSequence = psSettings->ui32Sequence;
+    g_sSettingsStored = *psSettings;
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Forgets the settings.
+//!
+//! Only the magic number of each valid slot is overwritten.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+SettingsErase(void)
+{
+    tSettings sSettings;
+    uint32_t ui32Slot;
+    uint32_t ui32Zero;
+
+    ui32Zero = 0;
+
+    for(ui32Slot = 0; ui32Slot < SETTINGS_SLOTS; ui32Slot++)
+    {
+        EEPROMRead(&sSettings.ui32Magic,
+                   SETTINGS_BASE + (ui32Slot * SETTINGS_SLOT_SIZE), 4);
+        if(sSettings.ui32Magic == SETTINGS_MAGIC)
+        {
+            EEPROMProgram(&ui32Zero,
+                          SETTINGS_BASE + (ui32Slot * SETTINGS_SLOT_SIZE), 4);
+        }
+    }
+
+    g_ui32SettingsSlot = SETTINGS_SLOTS;
+    g_ui32SettingsSequence = 0;
+    memset(&g_sSettingsStored, 0, sizeof(tSettings));
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
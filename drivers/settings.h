@@ -0,0 +1,82 @@
+//*****************************************************************************
+//
+// settings.h - Prototypes for the network settings kept in EEPROM.
+//
+//*****************************************************************************
+
+#ifndef __SETTINGS_H__
+#define __SETTINGS_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The longest SSID, WPA2 passphrase and server host name kept.
+//
+//*****************************************************************************
+#define SETTINGS_SSID_SIZE      32
+#define SETTINGS_PASSWORD_SIZE  64
+#define SETTINGS_HOST_SIZE      47
+
+//*****************************************************************************
+//
+// The settings are written to SETTINGS_SLOTS slots in turn, each
+// SETTINGS_SLOT_SIZE bytes from SETTINGS_BASE, three 64 byte EEPROM blocks.
+//
+//*****************************************************************************
+#define SETTINGS_BASE           0
+#define SETTINGS_SLOT_SIZE      192
+#define SETTINGS_SLOTS          8
+
+//*****************************************************************************
+//
+// The last network joined and server connected to.  An empty SSID or a port
+// of zero means there is none.  The BSSID and channel are those of the
+// access point joined, or zero if not known.  The size is a whole number of
+// words, as the EEPROM is written a word at a time.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Magic;
+    uint32_t ui32Sequence;
+    char pcSSID[SETTINGS_SSID_SIZE + 1];
+    char pcPassword[SETTINGS_PASSWORD_SIZE + 1];
+    uint8_t pui8BSSID[6];
+    uint8_t ui8Channel;
+    uint8_t ui8Reserved;
+    char pcHost[SETTINGS_HOST_SIZE + 1];
+    uint16_t ui16Port;
+    uint32_t ui32Check;
+}
+tSettings;
+
+//*****************************************************************************
+//
+// Functions exported from settings.c
+//
+//*****************************************************************************
+extern bool SettingsInit(void);
+extern bool SettingsLoad(tSettings *psSettings);
+extern bool SettingsSave(tSettings *psSettings);
+extern void SettingsErase(void);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SETTINGS_H__
@@ -0,0 +1,854 @@
+//*****************************************************************************
+//
+// uart_dma.c - uDMA driven transfers for the console and ESP8266 UARTs.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_uart.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "drivers/ringbuf.h"
+#include "drivers/uart_dma.h"
+
+//*****************************************************************************
+//
+//! \addtogroup uart_dma_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Transmit path.
+//
+// Each UART owns a transmit ring.  Callers copy their data into the ring and
+// return immediately; the uDMA channel of the UART then moves the longest
+// contiguous run of the ring into the UART data register.  When the channel
+// stops, the UART interrupt is raised, the run is released from the ring and
+// the next run is started, so the CPU is only involved once per run instead
+// of once per byte.
+//
+// Completion callbacks are kept in a small queue per UART, tagged with the
+// ring position just past the last byte of their buffer, and are called from
+// the UART interrupt once the ring has been consumed up to that position.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Receive path.
+//
+// The receive channel runs in ping-pong mode over two blocks: while the
+// primary block fills, the alternate one is ready, and the controller swaps
+// between them without CPU help.  Each completed block raises the UART
+// interrupt, which copies the block into the receive ring and re-arms it.
+//
+// The channel only answers burst requests, so fewer than a burst of bytes are
+// left in the FIFO when the line goes quiet.  That makes the UART raise its
+// receive timeout interrupt, which copies out whatever part of the active
+// block has been filled so far and then drains the FIFO by hand.  A short
+// response is therefore seen after 32 bit times of silence rather than after
+// a full block.
+//
+// Once the ring has less room than the blocks and the FIFO can still deliver,
+// the UART's receive requests and timeout interrupt are turned off, so bytes
+// wait in the FIFO instead of being dropped by the ring.  With RTS flow
+// control the full FIFO then holds the sender off; without it the UART
+// reports overruns.  UARTDMARxRelease(), called by the consumer, turns them
+// back on once it has made room.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The ring space that the receive side needs to keep taking bytes: both
+// blocks and the FIFO.
+//
+//*****************************************************************************
+#define UART_DMA_RX_RESERVE     ((2 * UART_DMA_RX_BLOCK) + 16)
+
+//*****************************************************************************
+//
+// The uDMA control table.  It must be aligned to a 1024 byte boundary.
+//
+//*****************************************************************************
+#if defined(ewarm)
+#pragma data_alignment=1024
+uint8_t g_pui8DMAControlTable[1024];
+#elif defined(ccs)
+#pragma DATA_ALIGN(g_pui8DMAControlTable, 1024)
+uint8_t g_pui8DMAControlTable[1024];
+#else
+uint8_t g_pui8DMAControlTable[1024] __attribute__ ((aligned(1024)));
+#endif
+
+//*****************************************************************************
+//
+// The count of uDMA errors seen by uDMAErrorHandler().
+//
+//*****************************************************************************
+volatile uint32_t g_ui32DMAErrors = 0;
+
+//*****************************************************************************
+//
+// A completion callback waiting for the ring to drain past ui32End.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32End;
+    tUARTDMACallback pfnCallback;
+    void *pvData;
+}
+tUARTDMAPending;
+
+//*****************************************************************************
+//
+// The transmit state of one UART.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Base;
+    uint32_t ui32Int;
+    uint32_t ui32Channel;
+    uint32_t ui32Assign;
+    tRingBuf *psRing;
+
+    //
+    // Number of ring bytes owned by the running transfer, zero when idle.
+    //
+    volatile uint32_t ui32InFlight;
+
+    //
+    // Pending callbacks.  Written by UARTDMASend(), read with the UART
+    // interrupt masked or from the interrupt itself.
+    //
+    tUARTDMAPending psPending[UART_DMA_NUM_CALLBACKS];
+    volatile uint32_t ui32PendingWrite;
+    volatile uint32_t ui32PendingRead;
+}
+tUARTDMATx;
+
+static tUARTDMATx g_psUARTDMATx[] =
+{
+    { UART0_BASE, INT_UART0, UDMA_CH9_UART0TX & 0x1f, UDMA_CH9_UART0TX },
+#ifdef MODEM_UART1
+    { UART1_BASE, INT_UART1, UDMA_CH23_UART1TX & 0x1f, UDMA_CH23_UART1TX },
+#else
+    { UART5_BASE, INT_UART5, UDMA_CH7_UART5TX & 0x1f, UDMA_CH7_UART5TX },
+#endif
+};
+
+#define NUM_UART_DMA_TX         (sizeof(g_psUARTDMATx) / sizeof(g_psUARTDMATx[0]))
+
+//*****************************************************************************
+//
+// The receive state of one UART.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Base;
+    uint32_t ui32Int;
+    uint32_t ui32Channel;
+    uint32_t ui32Assign;
+    tRingBuf *psRing;
+
+    //
+    // The two ping-pong blocks, index 0 on the primary control structure and
+    // index 1 on the alternate one.
+    //
+    uint8_t pui8Block[2][UART_DMA_RX_BLOCK];
+
+    //
+    // Bytes of each block already copied to the ring.
+    //
+    uint32_t pui32Consumed[2];
+
+    //
+    // The block the controller is filling, which is the next to complete.
+    //
+    uint32_t ui32Active;
+
+    //
+    // Set while receive requests are off for want of ring space, and the
+    // number of times that has happened.
+    //
+    volatile bool bHeld;
+    uint32_t ui32Holds;
+}
+tUARTDMARx;
+
+//*****************************************************************************
+//
+// The ESP8266 is on UART5, or on UART1 when built with MODEM_UART1.  Only
+// its UART has an entry, as each one holds its blocks.
+//
+//*****************************************************************************
+static tUARTDMARx g_psUARTDMARx[] =
+{
+#ifdef MODEM_UART1
+    { UART1_BASE, INT_UART1, UDMA_CH22_UART1RX & 0x1f, UDMA_CH22_UART1RX },
+#else
+    { UART5_BASE, INT_UART5, UDMA_CH6_UART5RX & 0x1f, UDMA_CH6_UART5RX },
+#endif
+};
+
+#define NUM_UART_DMA_RX         (sizeof(g_psUARTDMARx) / sizeof(g_psUARTDMARx[0]))
+
+//*****************************************************************************
+//
+// The control structure select of each ping-pong block.
+//
+//*****************************************************************************
+static const uint32_t g_pui32RxSelect[2] =
+{
+    UDMA_PRI_SELECT,
+    UDMA_ALT_SELECT
+};
+
+//*****************************************************************************
+//
+// Find the transmit state of a UART.
+//
+//*****************************************************************************
+static tUARTDMATx *
+UARTDMATxGet(uint32_t ui32Base)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_UART_DMA_TX; ui32Index++)
+    {
+        if(g_psUARTDMATx[ui32Index].ui32Base == ui32Base)
+        {
+            return(&g_psUARTDMATx[ui32Index]);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Start a transfer of the next contiguous run of the ring, if there is one.
+// Must be called with no transfer in flight.
+//
+//*****************************************************************************
+static void
+UARTDMATxStart(tUARTDMATx *psTx)
+{
+    uint8_t *pui8Data;
+    uint32_t ui32Count;
+
+    ui32Count = RingBufReadSpan(psTx->psRing, &pui8Data);
+
+    if(ui32Count > UART_DMA_MAX_XFER)
+    {
+        ui32Count = UART_DMA_MAX_XFER;
+    }
+
+    psTx->ui32InFlight = ui32Count;
+
+    if(ui32Count)
+    {
+        uDMAChannelTransferSet(psTx->ui32Channel | UDMA_PRI_SELECT,
+                               UDMA_MODE_BASIC, pui8Data,
+                               (void *)(psTx->ui32Base + UART_O_DR),
+                               ui32Count);
+        uDMAChannelEnable(psTx->ui32Channel);
+    }
+}
+
+//*****************************************************************************
+//
+// Call the callbacks of every buffer that has left the ring.
+//
+//*****************************************************************************
+static void
+UARTDMATxCallbacks(tUARTDMATx *psTx)
+{
+    tUARTDMAPending *psPending;
+
+    while(psTx->ui32PendingRead != psTx->ui32PendingWrite)
+    {
+        psPending = &psTx->psPending[psTx->ui32PendingRead %
+                                     UART_DMA_NUM_CALLBACKS];
+
+        if((int32_t)(psTx->psRing->ui32Read - psPending->ui32End) < 0)
+        {
+            break;
+        }
+
+        psPending->pfnCallback(psPending->pvData);
+        psTx->ui32PendingRead++;
+    }
+}
+
+//*****************************************************************************
+//
+// Make sure the transmitter is running if the ring has data.  Safe to call
+// from thread context.
+//
+//*****************************************************************************
+static void
+UARTDMATxKick(tUARTDMATx *psTx)
+{
+    IntDisable(psTx->ui32Int);
+    UARTDMATxIntHandler(psTx->ui32Base);
+    IntEnable(psTx->ui32Int);
+}
+
+//*****************************************************************************
+//
+// Find the receive state of a UART.
+//
+//*****************************************************************************
+static tUARTDMARx *
+UARTDMARxGet(uint32_t ui32Base)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_UART_DMA_RX; ui32Index++)
+    {
+        if(g_psUARTDMARx[ui32Index].ui32Base == ui32Base)
+        {
+            return(&g_psUARTDMARx[ui32Index]);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Arm one ping-pong block to receive a full block.
+//
+//*****************************************************************************
+static void
+UARTDMARxArm(tUARTDMARx *psRx, uint32_t ui32Block)
+{
+    psRx->pui32Consumed[ui32Block] = 0;
+    uDMAChannelTransferSet(psRx->ui32Channel | g_pui32RxSelect[ui32Block],
+                           UDMA_MODE_PINGPONG,
+                           (void *)(psRx->ui32Base + UART_O_DR),
+                           psRx->pui8Block[ui32Block], UART_DMA_RX_BLOCK);
+}
+
+//*****************************************************************************
+//
+// Copy the bytes of a block received since the last copy into the ring.
+//
+//*****************************************************************************
+static void
+UARTDMARxCopy(tUARTDMARx *psRx, uint32_t ui32Block, uint32_t ui32Filled)
+{
+    uint32_t ui32Consumed;
+
+    ui32Consumed = psRx->pui32Consumed[ui32Block];
+
+    while(ui32Consumed < ui32Filled)
+    {
+        RingBufPut(psRx->psRing, psRx->pui8Block[ui32Block][ui32Consumed++]);
+    }
+
+    psRx->pui32Consumed[ui32Block] = ui32Consumed;
+}
+
+//*****************************************************************************
+//
+//! Enables the uDMA controller.
+//!
+//! The uDMA peripheral must have been enabled with SysCtlPeripheralEnable()
+//! before calling this function.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMAInit(void)
+{
+    uDMAEnable();
+    uDMAControlBaseSet(g_pui8DMAControlTable);
+    IntEnable(INT_UDMAERR);
+}
+
+//*****************************************************************************
+//
+//! Switches the transmit side of a UART over to uDMA.
+//!
+//! \param ui32Base is the base address of the UART, either \b UART0_BASE or
+//! \b UART5_BASE (\b UART1_BASE when built with \b MODEM_UART1).
+//! \param psRing is the transmit ring for the UART.
+//!
+//! The UART must already be configured.  Its transmit interrupt is disabled,
+//! and its NVIC interrupt enabled since that is where the uDMA channel
+//! signals completion.  The UART interrupt handler must call
+//! UARTDMATxIntHandler().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMATxInit(uint32_t ui32Base, tRingBuf *psRing)
+{
+    tUARTDMATx *psTx;
+
+    psTx = UARTDMATxGet(ui32Base);
+    if(!psTx)
+    {
+        return;
+    }
+
+    psTx->psRing = psRing;
+    psTx->ui32InFlight = 0;
+    psTx->ui32PendingWrite = 0;
+    psTx->ui32PendingRead = 0;
+
+    uDMAChannelAssign(psTx->ui32Assign);
+    uDMAChannelAttributeDisable(psTx->ui32Channel,
+                                UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                                UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+
+    //
+    // Bytes go from an incrementing source to the fixed data register.
+    // Single requests are left enabled so that runs of any length complete.
+    //
+    uDMAChannelControlSet(psTx->ui32Channel | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE |
+                          UDMA_ARB_4);
+
+    UARTIntDisable(ui32Base, UART_INT_TX);
+    UARTDMAEnable(ui32Base, UART_DMA_TX);
+    IntEnable(psTx->ui32Int);
+}
+
+//*****************************************************************************
+//
+//! Queues as much of a buffer as fits for transmission.
+//!
+//! \param ui32Base is the base address of the UART.
+//! \param pui8Data points to the data to send.
+//! \param ui32Count is the number of bytes to send.
+//!
+//! The bytes are copied into the transmit ring, so the buffer may be reused
+//! as soon as this function returns.  It never waits.
+//!
+//! \return Returns the number of bytes queued.
+//
+//*****************************************************************************
+uint32_t
+UARTDMAWrite(uint32_t ui32Base, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    tUARTDMATx *psTx;
+
+    psTx = UARTDMATxGet(ui32Base);
+    if(!psTx || !psTx->psRing)
+    {
+        return(0);
+    }
+
+    ui32Count = RingBufWrite(psTx->psRing, pui8Data, ui32Count);
+    UARTDMATxKick(psTx);
+
+    return(ui32Count);
+}
+
+//*****************************************************************************
+//
+//! Queues a whole buffer for transmission with a completion callback.
+//!
+//! \param ui32Base is the base address of the UART.
+//! \param pui8Data points to the data to send.
+//! \param ui32Count is the number of bytes to send.
+//! \param pfnCallback is called once the last byte has been handed to the
+//! UART, or 0 for no callback.
+//! \param pvData is passed to \e pfnCallback.
+//!
+//! Either the whole buffer is queued or nothing is.  The callback runs in the
+//! UART interrupt handler.
+//!
+//! \return Returns \b true if the buffer was queued, \b false if there was not
+//! enough room in the ring or the callback queue.
+//
+//*****************************************************************************
+bool
+UARTDMASend(uint32_t ui32Base, const uint8_t *pui8Data, uint32_t ui32Count,
+            tUARTDMACallback pfnCallback, void *pvData)
+{
+    tUARTDMATx *psTx;
+    tUARTDMAPending *psPending;
+
+    psTx = UARTDMATxGet(ui32Base);
+    if(!psTx || !psTx->psRing || (RingBufFree(psTx->psRing) < ui32Count))
+    {
+        return(false);
+    }
+
+    if(pfnCallback && ((psTx->ui32PendingWrite - psTx->ui32PendingRead) >=
+                       UART_DMA_NUM_CALLBACKS))
+    {
+        return(false);
+    }
+
+    RingBufWrite(psTx->psRing, pui8Data, ui32Count);
+
+    if(pfnCallback)
+    {
+        psPending = &psTx->psPending[psTx->ui32PendingWrite %
+                                     UART_DMA_NUM_CALLBACKS];
+        psPending->ui32End = psTx->psRing->ui32Write;
+        psPending->pfnCallback = pfnCallback;
+        psPending->pvData = pvData;
+        RING_BARRIER();
+        psTx->ui32PendingWrite++;
+    }
+
+    UARTDMATxKick(psTx);
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+//! Reports whether a UART still has data queued or in flight.
+//!
+//! \param ui32Base is the base address of the UART.
+//!
+//! \return Returns \b true until every queued byte has been handed to the
+//! UART.
+//
+//*****************************************************************************
+bool
+UARTDMATxBusy(uint32_t ui32Base)
+{
+    tUARTDMATx *psTx;
+
+    psTx = UARTDMATxGet(ui32Base);
+    if(!psTx || !psTx->psRing)
+    {
+        return(false);
+    }
+
+    return(psTx->ui32InFlight || RingBufUsed(psTx->psRing));
+}
+
+//*****************************************************************************
+//
+//! Services the transmit channel of a UART.
+//!
+//! \param ui32Base is the base address of the UART.
+//!
+//! Must be called from the interrupt handler of every UART set up with
+//! UARTDMATxInit().  When the running transfer has finished it releases the
+//! transferred bytes, runs due callbacks and starts the next transfer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMATxIntHandler(uint32_t ui32Base)
+{
+    tUARTDMATx *psTx;
+
+    psTx = UARTDMATxGet(ui32Base);
+    if(!psTx || !psTx->psRing)
+    {
+        return;
+    }
+
+    if(psTx->ui32InFlight)
+    {
+        if(uDMAChannelIsEnabled(psTx->ui32Channel))
+        {
+            return;
+        }
+
+        RingBufAdvance(psTx->psRing, psTx->ui32InFlight);
+        psTx->ui32InFlight = 0;
+    }
+
+    UARTDMATxCallbacks(psTx);
+    UARTDMATxStart(psTx);
+}
+
+//*****************************************************************************
+//
+//! Switches the receive side of a UART over to uDMA ping-pong mode.
+//!
+//! \param ui32Base is the base address of the UART, currently only
+//! \b UART5_BASE (\b UART1_BASE when built with \b MODEM_UART1).
+//! \param psRing is the ring that receives the bytes.  It must hold more
+//! than two blocks and a FIFO of bytes.
+//!
+//! The UART must already be configured.  Its receive interrupt is replaced by
+//! the receive timeout interrupt, and the UART interrupt handler must call
+//! UARTDMARxIntHandler() with the interrupt status it read.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMARxInit(uint32_t ui32Base, tRingBuf *psRing)
+{
+    tUARTDMARx *psRx;
+
+    psRx = UARTDMARxGet(ui32Base);
+    if(!psRx)
+    {
+        return;
+    }
+
+    psRx->psRing = psRing;
+    psRx->ui32Active = 0;
+    psRx->bHeld = false;
+    psRx->ui32Holds = 0;
+
+    uDMAChannelAssign(psRx->ui32Assign);
+    uDMAChannelAttributeDisable(psRx->ui32Channel,
+                                UDMA_ATTR_ALTSELECT | UDMA_ATTR_HIGH_PRIORITY |
+                                UDMA_ATTR_REQMASK);
+
+    //
+    // Only burst requests, so that a partial burst stays in the FIFO and
+    // raises the receive timeout.  The burst matches the half full FIFO
+    // trigger level.
+    //
+    uDMAChannelAttributeEnable(psRx->ui32Channel, UDMA_ATTR_USEBURST);
+    UARTFIFOLevelSet(ui32Base, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+
+    uDMAChannelControlSet(psRx->ui32Channel | UDMA_PRI_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 |
+                          UDMA_ARB_8);
+    uDMAChannelControlSet(psRx->ui32Channel | UDMA_ALT_SELECT,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 |
+                          UDMA_ARB_8);
+
+    UARTDMARxArm(psRx, 0);
+    UARTDMARxArm(psRx, 1);
+
+    UARTIntDisable(ui32Base, UART_INT_RX);
+    UARTIntEnable(ui32Base, UART_INT_RT);
+    UARTDMAEnable(ui32Base, UART_DMA_RX);
+    uDMAChannelEnable(psRx->ui32Channel);
+}
+
+//*****************************************************************************
+//
+//! Services the receive channel of a UART.
+//!
+//! \param ui32Base is the base address of the UART.
+//! \param ui32Status is the interrupt status read by the caller.
+//!
+//! Must be called from the interrupt handler of every UART set up with
+//! UARTDMARxInit().  Completed blocks are copied into the ring and re-armed.
+//! On a receive timeout the filled part of the active block and the bytes
+//! left in the FIFO are copied as well.  If the ring is then short of room
+//! the channel is held until UARTDMARxRelease().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMARxIntHandler(uint32_t ui32Base, uint32_t ui32Status)
+{
+    tUARTDMARx *psRx;
+    uint32_t ui32Select;
+
+    psRx = UARTDMARxGet(ui32Base);
+    if(!psRx || !psRx->psRing)
+    {
+        return;
+    }
+
+    //
+    // Retire completed blocks in the order they were filled.
+    //
+    while(1)
+    {
+        ui32Select = g_pui32RxSelect[psRx->ui32Active];
+
+        if(uDMAChannelModeGet(psRx->ui32Channel | ui32Select) !=
+           UDMA_MODE_STOP)
+        {
+            break;
+        }
+
+        UARTDMARxCopy(psRx, psRx->ui32Active, UART_DMA_RX_BLOCK);
+        UARTDMARxArm(psRx, psRx->ui32Active);
+        psRx->ui32Active ^= 1;
+    }
+
+    //
+    // If both blocks filled before this handler ran, the controller stopped
+    // the channel.  Both are armed again now, so restart it.
+    //
+    if(!uDMAChannelIsEnabled(psRx->ui32Channel))
+    {
+        uDMAChannelEnable(psRx->ui32Channel);
+    }
+
+    if(ui32Status & UART_INT_RT)
+    {
+        //
+        // The size left in the control word counts down as bursts land.  If
+        // the block completes meanwhile the size reads as zero, the whole
+        // block is copied here and the completion only re-arms it.
+        //
+        UARTDMARxCopy(psRx, psRx->ui32Active, UART_DMA_RX_BLOCK -
+                      uDMAChannelSizeGet(psRx->ui32Channel | ui32Select));
+
+        //
+        // The line has been idle for 32 bit times, so the FIFO holds less
+        // than a burst and cannot grow to one before it has been emptied.
+        //
+        while(UARTCharsAvail(ui32Base))
+        {
+            RingBufPut(psRx->psRing, UARTCharGetNonBlocking(ui32Base));
+        }
+    }
+
+    //
+    // Stop taking bytes while the ring could not hold what the blocks and
+    // the FIFO may yet bring.
+    //
+    if(!psRx->bHeld && (RingBufFree(psRx->psRing) < UART_DMA_RX_RESERVE))
+    {
+        UARTDMADisable(ui32Base, UART_DMA_RX);
+        UARTIntDisable(ui32Base, UART_INT_RT);
+        psRx->bHeld = true;
+        psRx->ui32Holds++;
+    }
+}
+
+//*****************************************************************************
+//
+//! Lets a held receive channel take bytes again.
+//!
+//! \param ui32Base is the base address of the UART.
+//!
+//! UARTDMARxIntHandler() stops the receive requests of the UART when its
+//! ring runs short of room.  The consumer of the ring calls this after it
+//! has read from the ring; once there is room again the requests and the
+//! receive timeout are turned back on.  It costs one test while the channel
+//! is not held.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMARxRelease(uint32_t ui32Base)
+{
+    tUARTDMARx *psRx;
+
+    psRx = UARTDMARxGet(ui32Base);
+    if(!psRx || !psRx->bHeld ||
+       (RingBufFree(psRx->psRing) < UART_DMA_RX_RESERVE))
+    {
+        return;
+    }
+
+    IntDisable(psRx->ui32Int);
+    psRx->bHeld = false;
+    UARTIntEnable(ui32Base, UART_INT_RT);
+    UARTDMAEnable(ui32Base, UART_DMA_RX);
+    IntEnable(psRx->ui32Int);
+}
+
+//*****************************************************************************
+//
+//! Returns the number of times a receive channel has been held.
+//!
+//! \param ui32Base is the base address of the UART.
+//!
+//! \return Returns how often the ring of the UART ran short of room, so that
+//! its receive requests were stopped.
+//
+//*****************************************************************************
+uint32_t
+UARTDMARxHolds(uint32_t ui32Base)
+{
+    tUARTDMARx *psRx;
+
+    psRx = UARTDMARxGet(ui32Base);
+
+    return(psRx ? psRx->ui32Holds : 0);
+}
+
+//*****************************************************************************
+//
+//! Collects received bytes that no interrupt will report.
+//!
+//! \param ui32Base is the base address of the UART.
+//!
+//! The receive timeout is only raised while the FIFO holds data.  When the
+//! last bytes of a burst of traffic happen to complete a uDMA burst, the FIFO
+//! is left empty and those bytes wait in the active block until more arrive.
+//! Calling this from thread context whenever the ring runs dry copies them
+//! into the ring.  It costs one read of the channel control word.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+UARTDMARxPoll(uint32_t ui32Base)
+{
+    tUARTDMARx *psRx;
+    uint32_t ui32Select;
+    uint32_t ui32Filled;
+
+    psRx = UARTDMARxGet(ui32Base);
+    if(!psRx || !psRx->psRing)
+    {
+        return;
+    }
+
+    IntDisable(psRx->ui32Int);
+
+    //
+    // As for the receive timeout, a block that completed meanwhile reads as
+    // size zero and is copied whole; its completion then only re-arms it.
+    //
+    ui32Select = g_pui32RxSelect[psRx->ui32Active];
+    ui32Filled = UART_DMA_RX_BLOCK -
+                 uDMAChannelSizeGet(psRx->ui32Channel | ui32Select);
+    if(ui32Filled > psRx->pui32Consumed[psRx->ui32Active])
+    {
+        UARTDMARxCopy(psRx, psRx->ui32Active, ui32Filled);
+    }
+
+    IntEnable(psRx->ui32Int);
+}
+
+//*****************************************************************************
+//
+//! The uDMA error interrupt handler.
+//!
+//! Clears and counts uDMA bus errors.  This function must be in the NVIC
+//! table in the startup file.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+uDMAErrorHandler(void)
+{
+    if(uDMAErrorStatusGet())
+    {
+        uDMAErrorStatusClear();
+        g_ui32DMAErrors++;
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,82 @@
+//*****************************************************************************
+//
+// uart_dma.h - Prototypes for the uDMA driven UART transfer driver.
+//
+//*****************************************************************************
+
+#ifndef __UART_DMA_H__
+#define __UART_DMA_H__
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The largest number of bytes a single uDMA basic mode transfer can move.
+//
+//*****************************************************************************
+#define UART_DMA_MAX_XFER       1024
+
+//*****************************************************************************
+//
+// The number of completion callbacks that can be pending on one UART.
+//
+//*****************************************************************************
+#define UART_DMA_NUM_CALLBACKS  4
+
+//*****************************************************************************
+//
+// The size of each of the two receive blocks used in ping-pong mode.  At
+// 115200 baud this is one interrupt per 128 bytes, about 90 a second under
+// continuous traffic, instead of one per half full FIFO.
+//
+//*****************************************************************************
+#define UART_DMA_RX_BLOCK       128
+
+//*****************************************************************************
+//
+// Completion callback for UARTDMASend().  Called from the UART interrupt
+// handler once the last byte of the buffer has been handed to the UART.
+//
+//*****************************************************************************
+typedef void (*tUARTDMACallback)(void *pvData);
+
+//*****************************************************************************
+//
+// Functions exported from uart_dma.c
+//
+//*****************************************************************************
+extern void UARTDMAInit(void);
+extern void UARTDMATxInit(uint32_t ui32Base, tRingBuf *psRing);
+extern uint32_t UARTDMAWrite(uint32_t ui32Base, const uint8_t *pui8Data,
+                             uint32_t ui32Count);
+extern bool UARTDMASend(uint32_t ui32Base, const uint8_t *pui8Data,
+                        uint32_t ui32Count, tUARTDMACallback pfnCallback,
+                        void *pvData);
+extern bool UARTDMATxBusy(uint32_t ui32Base);
+extern void UARTDMATxIntHandler(uint32_t ui32Base);
+extern void UARTDMARxInit(uint32_t ui32Base, tRingBuf *psRing);
+extern void UARTDMARxIntHandler(uint32_t ui32Base, uint32_t ui32Status);
+extern void UARTDMARxPoll(uint32_t ui32Base);
+extern void UARTDMARxRelease(uint32_t ui32Base);
+extern uint32_t UARTDMARxHolds(uint32_t ui32Base);
+extern void uDMAErrorHandler(void);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UART_DMA_H__
@@ -0,0 +1,27 @@
+//*****************************************************************************
+//
+// eeprom.h - Host build subset of the TivaWare EEPROM API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_EEPROM_H__
+#define __DRIVERLIB_EEPROM_H__
+
+#define EEPROM_INIT_OK          0
+#define EEPROM_INIT_ERROR       2
+
+#define EEPROMAddrFromBlock(ui32Block)                                        \
+        ((ui32Block) << 6)
+#define EEPROMBlockFromAddr(ui32Addr)                                         \
+        ((ui32Addr) >> 6)
+
+extern uint32_t EEPROMInit(void);
+extern uint32_t EEPROMSizeGet(void);
+extern uint32_t EEPROMBlockCountGet(void);
+extern void EEPROMRead(uint32_t *pui32Data, uint32_t ui32Address,
+                       uint32_t ui32Count);
+extern uint32_t EEPROMProgram(uint32_t *pui32Data, uint32_t ui32Address,
+                              uint32_t ui32Count);
+extern uint32_t EEPROMMassErase(void);
+
+#endif // __DRIVERLIB_EEPROM_H__
@@ -0,0 +1,13 @@
+//*****************************************************************************
+//
+// fpu.h - Host build subset of the TivaWare FPU API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_FPU_H__
+#define __DRIVERLIB_FPU_H__
+
+extern void FPUEnable(void);
+extern void FPULazyStackingEnable(void);
+
+#endif // __DRIVERLIB_FPU_H__
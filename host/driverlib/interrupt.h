@@ -0,0 +1,18 @@
+//*****************************************************************************
+//
+// interrupt.h - Host build subset of the TivaWare NVIC API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+extern bool IntMasterEnable(void);
+extern bool IntMasterDisable(void);
+extern void IntEnable(uint32_t ui32Interrupt);
+extern void IntDisable(uint32_t ui32Interrupt);
+extern uint32_t IntIsEnabled(uint32_t ui32Interrupt);
+extern void IntPendSet(uint32_t ui32Interrupt);
+extern void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority);
+
+#endif // __DRIVERLIB_INTERRUPT_H__
@@ -0,0 +1,26 @@
+//*****************************************************************************
+//
+// pin_map.h - Host build subset of the TM4C123GH6PM pin mux definitions.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_PIN_MAP_H__
+#define __DRIVERLIB_PIN_MAP_H__
+
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PB0_U1RX           0x00010001
+#define GPIO_PB1_U1TX           0x00010401
+#define GPIO_PC4_U1RX           0x00021002
+#define GPIO_PC5_U1TX           0x00021402
+#define GPIO_PC4_U1RTS          0x00021008
+#define GPIO_PC5_U1CTS          0x00021408
+#define GPIO_PE4_U5RX           0x00041001
+#define GPIO_PE5_U5TX           0x00041401
+#define GPIO_PF0_U1RTS          0x00050001
+#define GPIO_PF1_U1CTS          0x00050401
+#define GPIO_PF1_T0CCP1         0x00050407
+#define GPIO_PF2_T1CCP0         0x00050807
+#define GPIO_PF3_T1CCP1         0x00050C07
+
+#endif // __DRIVERLIB_PIN_MAP_H__
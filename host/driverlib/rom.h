@@ -0,0 +1,33 @@
+//*****************************************************************************
+//
+// rom.h - Host build mapping of the ROM driverlib entry points.
+//
+// There is no ROM on the host, so every ROM_ call goes to the shim.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_ROM_H__
+#define __DRIVERLIB_ROM_H__
+
+#define ROM_GPIODirModeSet              GPIODirModeSet
+#define ROM_GPIOPadConfigSet            GPIOPadConfigSet
+#define ROM_GPIOPinConfigure            GPIOPinConfigure
+#define ROM_GPIOPinRead                 GPIOPinRead
+#define ROM_GPIOPinTypeGPIOInput        GPIOPinTypeGPIOInput
+#define ROM_GPIOPinTypeGPIOOutput       GPIOPinTypeGPIOOutput
+#define ROM_GPIOPinTypeTimer            GPIOPinTypeTimer
+#define ROM_GPIOPinWrite                GPIOPinWrite
+#define ROM_IntEnable                   IntEnable
+#define ROM_IntDisable                  IntDisable
+#define ROM_SysCtlClockGet              SysCtlClockGet
+#define ROM_SysCtlPeripheralEnable      SysCtlPeripheralEnable
+#define ROM_TimerConfigure              TimerConfigure
+#define ROM_TimerDisable                TimerDisable
+#define ROM_TimerEnable                 TimerEnable
+#define ROM_TimerIntClear               TimerIntClear
+#define ROM_TimerIntEnable              TimerIntEnable
+#define ROM_TimerLoadSet                TimerLoadSet
+#define ROM_TimerLoadSet64              TimerLoadSet64
+#define ROM_TimerMatchSet               TimerMatchSet
+
+#endif // __DRIVERLIB_ROM_H__
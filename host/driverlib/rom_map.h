@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// rom_map.h - Host build mapping of the MAP_ driverlib entry points.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_ROM_MAP_H__
+#define __DRIVERLIB_ROM_MAP_H__
+
+#define MAP_GPIOPadConfigSet            GPIOPadConfigSet
+
+#endif // __DRIVERLIB_ROM_MAP_H__
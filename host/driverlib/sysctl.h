@@ -0,0 +1,49 @@
+//*****************************************************************************
+//
+// sysctl.h - Host build subset of the TivaWare system control API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_SYSCTL_H__
+#define __DRIVERLIB_SYSCTL_H__
+
+#define SYSCTL_PERIPH_GPIOA     0xf0000800
+#define SYSCTL_PERIPH_GPIOB     0xf0000801
+#define SYSCTL_PERIPH_GPIOC     0xf0000802
+#define SYSCTL_PERIPH_GPIOD     0xf0000803
+#define SYSCTL_PERIPH_GPIOE     0xf0000804
+#define SYSCTL_PERIPH_GPIOF     0xf0000805
+#define SYSCTL_PERIPH_TIMER0    0xf0000400
+#define SYSCTL_PERIPH_TIMER1    0xf0000401
+#define SYSCTL_PERIPH_TIMER2    0xf0000402
+#define SYSCTL_PERIPH_UART0     0xf0001800
+#define SYSCTL_PERIPH_UART1     0xf0001801
+#define SYSCTL_PERIPH_UART5     0xf0001805
+#define SYSCTL_PERIPH_UDMA      0xf0000c00
+#define SYSCTL_PERIPH_EEPROM0   0xf0005800
+#define SYSCTL_PERIPH_WTIMER5   0xf0005c05
+
+#define SYSCTL_SYSDIV_1         0x07800000
+#define SYSCTL_SYSDIV_2         0x00C00000
+#define SYSCTL_SYSDIV_3         0x01400000
+#define SYSCTL_SYSDIV_4         0x01C00000
+#define SYSCTL_SYSDIV_5         0x02400000
+#define SYSCTL_SYSDIV_8         0x03C00000
+#define SYSCTL_SYSDIV_10        0x04C00000
+#define SYSCTL_SYSDIV_16        0x07C00000
+#define SYSCTL_SYSDIV_2_5       0xC1000000
+#define SYSCTL_USE_PLL          0x00000000
+#define SYSCTL_USE_OSC          0x00003800
+#define SYSCTL_OSC_MAIN         0x00000000
+#define SYSCTL_OSC_INT          0x00000010
+#define SYSCTL_XTAL_16MHZ       0x00000540
+
+extern void SysCtlPeripheralEnable(uint32_t ui32Peripheral);
+extern void SysCtlPeripheralDisable(uint32_t ui32Peripheral);
+extern bool SysCtlPeripheralReady(uint32_t ui32Peripheral);
+extern void SysCtlClockSet(uint32_t ui32Config);
+extern uint32_t SysCtlClockGet(void);
+extern void SysCtlDelay(uint32_t ui32Count);
+extern void SysCtlSleep(void);
+
+#endif // __DRIVERLIB_SYSCTL_H__
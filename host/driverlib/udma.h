@@ -0,0 +1,73 @@
+//*****************************************************************************
+//
+// udma.h - Host build subset of the TivaWare uDMA API.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_UDMA_H__
+#define __DRIVERLIB_UDMA_H__
+
+#define UDMA_ATTR_USEBURST      0x00000001
+#define UDMA_ATTR_ALTSELECT     0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY 0x00000004
+#define UDMA_ATTR_REQMASK       0x00000008
+#define UDMA_ATTR_ALL           0x0000000F
+
+#define UDMA_MODE_STOP          0x00000000
+#define UDMA_MODE_BASIC         0x00000001
+#define UDMA_MODE_AUTO          0x00000002
+#define UDMA_MODE_PINGPONG      0x00000003
+
+#define UDMA_DST_INC_8          0x00000000
+#define UDMA_DST_INC_16         0x40000000
+#define UDMA_DST_INC_32         0x80000000
+#define UDMA_DST_INC_NONE       0xc0000000
+#define UDMA_SRC_INC_8          0x00000000
+#define UDMA_SRC_INC_16         0x04000000
+#define UDMA_SRC_INC_32         0x08000000
+#define UDMA_SRC_INC_NONE       0x0c000000
+#define UDMA_SIZE_8             0x00000000
+#define UDMA_ARB_1              0x00000000
+#define UDMA_ARB_2              0x00004000
+#define UDMA_ARB_4              0x00008000
+#define UDMA_ARB_8              0x0000c000
+#define UDMA_ARB_16             0x00010000
+
+#define UDMA_PRI_SELECT         0x00000000
+#define UDMA_ALT_SELECT         0x00000020
+
+#define UDMA_CHANNEL_UART0RX    8
+#define UDMA_CHANNEL_UART0TX    9
+#define UDMA_CHANNEL_UART1RX    22
+#define UDMA_CHANNEL_UART1TX    23
+
+#define UDMA_CH6_UART5RX        0x00020006
+#define UDMA_CH7_UART5TX        0x00020007
+#define UDMA_CH8_UART0RX        0x00000008
+#define UDMA_CH9_UART0TX        0x00000009
+#define UDMA_CH22_UART1RX       0x00000016
+#define UDMA_CH23_UART1TX       0x00000017
+
+extern void uDMAEnable(void);
+extern void uDMADisable(void);
+extern uint32_t uDMAErrorStatusGet(void);
+extern void uDMAErrorStatusClear(void);
+extern void uDMAChannelEnable(uint32_t ui32ChannelNum);
+extern void uDMAChannelDisable(uint32_t ui32ChannelNum);
+extern bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum);
+extern void uDMAControlBaseSet(void *pControlTable);
+extern void uDMAChannelAttributeEnable(uint32_t ui32ChannelNum,
+                                       uint32_t ui32Attr);
+extern void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum,
+                                        uint32_t ui32Attr);
+extern uint32_t uDMAChannelAttributeGet(uint32_t ui32ChannelNum);
+extern void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex,
+                                  uint32_t ui32Control);
+extern void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex,
+                                   uint32_t ui32Mode, void *pvSrcAddr,
+                                   void *pvDstAddr, uint32_t ui32TransferSize);
+extern uint32_t uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex);
+extern uint32_t uDMAChannelModeGet(uint32_t ui32ChannelStructIndex);
+extern void uDMAChannelAssign(uint32_t ui32Mapping);
+
+#endif // __DRIVERLIB_UDMA_H__
@@ -0,0 +1,56 @@
+//*****************************************************************************
+//
+// host.h - Internal interfaces shared by the host build hardware shim.
+//
+//*****************************************************************************
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+// All emulated peripheral state is protected by one recursive lock.  The
+// interrupt thread holds it for the whole time a handler runs, so thread
+// context code calling into the shim is held off exactly as if the handler
+// had preempted it on the target.  Anything that changes state others may be
+// waiting for broadcasts the shared condition variable.
+//
+//*****************************************************************************
+extern void HostLock(void);
+extern void HostUnlock(void);
+extern void HostWait(uint64_t ui64DeadlineNs);
+extern void HostSignal(void);
+
+//*****************************************************************************
+//
+// Interrupt controller.
+//
+//*****************************************************************************
+extern void HostIntPend(uint32_t ui32Interrupt);
+extern void (* const g_pfnHostVectors[])(void);
+
+//*****************************************************************************
+//
+// Time.  HostNow() is a monotonic clock in nanoseconds; HostSleepUntil()
+// sleeps without holding the lock.
+//
+//*****************************************************************************
+extern uint64_t HostNow(void);
+extern void HostSleepUntil(uint64_t ui64DeadlineNs);
+extern uint32_t g_ui32HostClock;
+
+//*****************************************************************************
+//
+// Peripheral models started from the shim constructor.
+//
+//*****************************************************************************
+extern void HostUARTStart(void);
+extern void HostTimerStart(void);
+extern void HostTimerClockSet(uint64_t ui64Now, uint32_t ui32OldHz,
+                              uint32_t ui32NewHz);
+extern void HostGPIOInput(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+
+#endif // __HOST_H__
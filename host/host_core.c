@@ -0,0 +1,509 @@
+//*****************************************************************************
+//
+// host_core.c - Interrupt controller, clock and register file of the host
+//               build hardware shim.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/fpu.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "host.h"
+
+//*****************************************************************************
+//
+// The lock and condition variable shared by every peripheral model.
+//
+//*****************************************************************************
+static pthread_mutex_t g_sHostMutex;
+static pthread_cond_t g_sHostCond;
+
+//*****************************************************************************
+//
+// The interrupt controller state.  Interrupts are taken in order of their
+// number, which is what the NVIC does when every priority is left at reset.
+//
+//*****************************************************************************
+static bool g_pbIntEnabled[NUM_INTERRUPTS];
+static bool g_pbIntPending[NUM_INTERRUPTS];
+static bool g_bIntMaster = true;
+static uint32_t g_ui32IntTaken;
+static pthread_t g_sNVICThread;
+
+//*****************************************************************************
+//
+// The system clock in Hz, as set by SysCtlClockSet().  The device comes out
+// of reset on the 16 MHz internal oscillator.
+//
+//*****************************************************************************
+uint32_t g_ui32HostClock = 16000000;
+
+//*****************************************************************************
+//
+// The register file behind HWREG().  The DWT cycle counter is the one
+// register with a life of its own: every access sees the host's monotonic
+// time in system clock cycles, so profiles taken on the host give host time
+// scaled to the target clock rather than target cycles.  It always runs, and
+// writes to it are lost.  A change of system clock changes its rate from
+// then on, without a jump.
+//
+//*****************************************************************************
+#define NUM_HOST_REGISTERS      1024
+#define HOST_DWT_CYCCNT         0xE0001004
+
+static uint64_t g_ui64HostCycles;
+static uint64_t g_ui64HostCyclesTime;
+
+static uint32_t g_pui32RegAddress[NUM_HOST_REGISTERS];
+static volatile uint32_t g_pui32RegValue[NUM_HOST_REGISTERS];
+
+void
+HostLock(void)
+{
+    pthread_mutex_lock(&g_sHostMutex);
+}
+
+void
+HostUnlock(void)
+{
+    pthread_mutex_unlock(&g_sHostMutex);
+}
+
+void
+HostSignal(void)
+{
+    pthread_cond_broadcast(&g_sHostCond);
+}
+
+uint64_t
+HostNow(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return(((uint64_t)sNow.tv_sec * 1000000000ull) + sNow.tv_nsec);
+}
+
+//*****************************************************************************
+//
+// Wait on the shared condition variable until signalled or until the
+// deadline passes.  A deadline of zero waits forever.  Must be called with
+// the lock held exactly once.
+//
+//*****************************************************************************
+void
+HostWait(uint64_t ui64DeadlineNs)
+{
+    struct timespec sDeadline;
+
+    if(ui64DeadlineNs == 0)
+    {
+        pthread_cond_wait(&g_sHostCond, &g_sHostMutex);
+        return;
+    }
+
+    sDeadline.tv_sec = ui64DeadlineNs / 1000000000ull;
+    sDeadline.tv_nsec = ui64DeadlineNs % 1000000000ull;
+    pthread_cond_timedwait(&g_sHostCond, &g_sHostMutex, &sDeadline);
+}
+
+void
+HostSleepUntil(uint64_t ui64DeadlineNs)
+{
+    struct timespec sDeadline;
+
+    sDeadline.tv_sec = ui64DeadlineNs / 1000000000ull;
+    sDeadline.tv_nsec = ui64DeadlineNs % 1000000000ull;
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sDeadline, 0))
+    {
+    }
+}
+
+volatile uint32_t *
+HostRegister(uint32_t ui32Address)
+{
+    uint32_t ui32Index;
+    uint32_t ui32Probe;
+
+    HostLock();
+
+    ui32Index = (ui32Address >> 2) % NUM_HOST_REGISTERS;
+
+    for(ui32Probe = 0; ui32Probe < NUM_HOST_REGISTERS; ui32Probe++)
+    {
+        if((g_pui32RegAddress[ui32Index] == ui32Address) ||
+           (g_pui32RegAddress[ui32Index] == 0))
+        {
+            break;
+        }
+
+        ui32Index = (ui32Index + 1) % NUM_HOST_REGISTERS;
+    }
+
+    g_pui32RegAddress[ui32Index] = ui32Address;
+
+    if(ui32Address == HOST_DWT_CYCCNT)
+    {
+        g_pui32RegValue[ui32Index] =
+            (uint32_t)(g_ui64HostCycles +
+                       (((HostNow() - g_ui64HostCyclesTime) *
+                         (g_ui32HostClock / 1000000)) / 1000));
+    }
+
+    HostUnlock();
+
+    return(&g_pui32RegValue[ui32Index]);
+}
+
+//*****************************************************************************
+//
+// Interrupt controller.
+//
+//*****************************************************************************
+void
+HostIntPend(uint32_t ui32Interrupt)
+{
+    if(ui32Interrupt < NUM_INTERRUPTS)
+    {
+        g_pbIntPending[ui32Interrupt] = true;
+        HostSignal();
+    }
+}
+
+//*****************************************************************************
+//
+// The lowest numbered interrupt that is pending and enabled, whether or not
+// the processor has interrupts masked, or 0 if there is none.
+//
+//*****************************************************************************
+static uint32_t
+HostIntPending(void)
+{
+    uint32_t ui32Interrupt;
+
+    for(ui32Interrupt = FAULT_SYSTICK; ui32Interrupt < NUM_INTERRUPTS;
+        ui32Interrupt++)
+    {
+        if(g_pbIntPending[ui32Interrupt] &&
+           ((ui32Interrupt < INT_GPIOA) || g_pbIntEnabled[ui32Interrupt]))
+        {
+            return(ui32Interrupt);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// The next interrupt to take, or 0 if there is none or interrupts are
+// masked.
+//
+//*****************************************************************************
+static uint32_t
+HostIntNext(void)
+{
+    if(!g_bIntMaster)
+    {
+        return(0);
+    }
+
+    return(HostIntPending());
+}
+
+static void *
+HostNVICThread(void *pvArg)
+{
+    uint32_t ui32Interrupt;
+
+    HostLock();
+
+    while(1)
+    {
+        ui32Interrupt = HostIntNext();
+
+        if(ui32Interrupt == 0)
+        {
+            HostWait(0);
+            continue;
+        }
+
+        g_pbIntPending[ui32Interrupt] = false;
+
+        if(g_pfnHostVectors[ui32Interrupt])
+        {
+            g_pfnHostVectors[ui32Interrupt]();
+        }
+
+        g_ui32IntTaken++;
+        HostSignal();
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Unmasking interrupts takes the pending ones before the next instruction,
+// so thread context waits here until they have run.  Handlers themselves
+// run in the interrupt thread and carry straight on.
+//
+//*****************************************************************************
+bool
+IntMasterEnable(void)
+{
+    bool bWasDisabled;
+
+    HostLock();
+    bWasDisabled = !g_bIntMaster;
+    g_bIntMaster = true;
+    HostSignal();
+    if(!pthread_equal(pthread_self(), g_sNVICThread))
+    {
+        while(HostIntNext())
+        {
+            HostWait(0);
+        }
+    }
+    HostUnlock();
+
+    return(bWasDisabled);
+}
+
+bool
+IntMasterDisable(void)
+{
+    bool bWasDisabled;
+
+    HostLock();
+    bWasDisabled = !g_bIntMaster;
+    g_bIntMaster = false;
+    HostUnlock();
+
+    return(bWasDisabled);
+}
+
+void
+IntEnable(uint32_t ui32Interrupt)
+{
+    HostLock();
+    g_pbIntEnabled[ui32Interrupt] = true;
+    HostSignal();
+    HostUnlock();
+}
+
+void
+IntDisable(uint32_t ui32Interrupt)
+{
+    HostLock();
+    g_pbIntEnabled[ui32Interrupt] = false;
+    HostUnlock();
+}
+
+uint32_t
+IntIsEnabled(uint32_t ui32Interrupt)
+{
+    return(g_pbIntEnabled[ui32Interrupt]);
+}
+
+void
+IntPendSet(uint32_t ui32Interrupt)
+{
+    HostLock();
+    HostIntPend(ui32Interrupt);
+    HostUnlock();
+}
+
+void
+IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority)
+{
+}
+
+//*****************************************************************************
+//
+// System control.
+//
+//*****************************************************************************
+void
+SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+}
+
+void
+SysCtlPeripheralDisable(uint32_t ui32Peripheral)
+{
+}
+
+bool
+SysCtlPeripheralReady(uint32_t ui32Peripheral)
+{
+    return(true);
+}
+
+void
+SysCtlClockSet(uint32_t ui32Config)
+{
+    uint32_t ui32Input;
+    uint32_t ui32Div;
+    uint64_t ui64Now;
+
+    //
+    // The oscillator paths run at 16 MHz on this board; the PLL output is
+    // 400 MHz, divided by two unless the DIV400 bit is set.
+    //
+    if((ui32Config & SYSCTL_USE_OSC) == SYSCTL_USE_OSC)
+    {
+        ui32Input = 16000000;
+        ui32Div = (ui32Config & 0x00400000) ? ((ui32Config >> 23) & 0xf) + 1 : 1;
+    }
+    else if(ui32Config & 0x80000000)
+    {
+        ui32Input = 400000000;
+        ui32Div = ((ui32Config >> 22) & 0x7f) + 1;
+    }
+    else
+    {
+        ui32Input = 200000000;
+        ui32Div = (ui32Config & 0x00400000) ? ((ui32Config >> 23) & 0xf) + 1 : 1;
+    }
+
+    //
+    // Counters running from the system clock carry on from where they are
+    // at the new rate.
+    //
+    HostLock();
+    ui64Now = HostNow();
+    g_ui64HostCycles += ((ui64Now - g_ui64HostCyclesTime) *
+                         (g_ui32HostClock / 1000000)) / 1000;
+    g_ui64HostCyclesTime = ui64Now;
+    HostTimerClockSet(ui64Now, g_ui32HostClock, ui32Input / ui32Div);
+    g_ui32HostClock = ui32Input / ui32Div;
+    HostSignal();
+    HostUnlock();
+}
+
+uint32_t
+SysCtlClockGet(void)
+{
+    return(g_ui32HostClock);
+}
+
+//*****************************************************************************
+//
+// SysCtlDelay() takes three cycles per count on the target.
+//
+//*****************************************************************************
+void
+SysCtlDelay(uint32_t ui32Count)
+{
+    HostSleepUntil(HostNow() +
+                   (((uint64_t)ui32Count * 3 * 1000000000ull) /
+                    g_ui32HostClock));
+}
+
+//*****************************************************************************
+//
+// Sleep until the next interrupt has been taken, like WFI.  As on the target,
+// an interrupt that becomes pending while interrupts are masked also ends the
+// sleep; it is taken once they are unmasked.
+//
+//*****************************************************************************
+void
+SysCtlSleep(void)
+{
+    uint32_t ui32Taken;
+
+    HostLock();
+    ui32Taken = g_ui32IntTaken;
+    while((ui32Taken == g_ui32IntTaken) && !HostIntPending())
+    {
+        HostWait(0);
+    }
+    HostUnlock();
+}
+
+void
+FPUEnable(void)
+{
+}
+
+void
+FPULazyStackingEnable(void)
+{
+}
+
+//*****************************************************************************
+//
+// SIGUSR1 presses and releases the left button, SIGUSR2 the right one.
+//
+//*****************************************************************************
+static void *
+HostSignalThread(void *pvArg)
+{
+    sigset_t sSignals;
+    int iSignal;
+    uint8_t ui8Pin;
+
+    sigemptyset(&sSignals);
+    sigaddset(&sSignals, SIGUSR1);
+    sigaddset(&sSignals, SIGUSR2);
+
+    while(sigwait(&sSignals, &iSignal) == 0)
+    {
+        ui8Pin = (iSignal == SIGUSR1) ? GPIO_PIN_4 : GPIO_PIN_0;
+
+        HostGPIOInput(GPIO_PORTF_BASE, ui8Pin, 0);
+        HostSleepUntil(HostNow() + 50000000ull);
+        HostGPIOInput(GPIO_PORTF_BASE, ui8Pin, ui8Pin);
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Bring up the shim before the firmware's main() runs.
+//
+//*****************************************************************************
+static void __attribute__((constructor))
+HostInit(void)
+{
+    pthread_mutexattr_t sMutexAttr;
+    pthread_condattr_t sCondAttr;
+    pthread_t sThread;
+    sigset_t sSignals;
+
+    pthread_mutexattr_init(&sMutexAttr);
+    pthread_mutexattr_settype(&sMutexAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&g_sHostMutex, &sMutexAttr);
+
+    pthread_condattr_init(&sCondAttr);
+    pthread_condattr_setclock(&sCondAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_sHostCond, &sCondAttr);
+
+    //
+    // Block the button signals everywhere but in the signal thread.  Threads
+    // created from here on inherit the mask.
+    //
+    sigemptyset(&sSignals);
+    sigaddset(&sSignals, SIGUSR1);
+    sigaddset(&sSignals, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &sSignals, 0);
+
+    pthread_create(&sThread, 0, HostSignalThread, 0);
+    pthread_create(&g_sNVICThread, 0, HostNVICThread, 0);
+
+    HostUARTStart();
+    HostTimerStart();
+}
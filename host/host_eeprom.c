@@ -0,0 +1,159 @@
+//*****************************************************************************
+//
+// host_eeprom.c - EEPROM model of the host build hardware shim.
+//
+// The 2 KB EEPROM of the TM4C123GH6PM, 32 blocks of 16 words, erased to all
+// ones.  With HOST_EEPROM set to a file name, the contents are loaded from
+// that file and written back to it on every program, so they survive a
+// restart as they would on the board.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "driverlib/eeprom.h"
+#include "host.h"
+
+#define HOST_EEPROM_SIZE        2048
+#define HOST_EEPROM_BLOCKS      32
+
+static uint32_t g_pui32HostEEPROM[HOST_EEPROM_SIZE / 4];
+static const char *g_pcHostEEPROMFile;
+static bool g_bHostEEPROMLoaded;
+
+//*****************************************************************************
+//
+// Write the contents back to the file, if there is one.
+//
+//*****************************************************************************
+static void
+HostEEPROMStore(void)
+{
+    FILE *psFile;
+
+    if(!g_pcHostEEPROMFile)
+    {
+        return;
+    }
+
+    psFile = fopen(g_pcHostEEPROMFile, "wb");
+    if(!psFile)
+    {
+        fprintf(stderr, "host: HOST_EEPROM: cannot write %s\n",
+                g_pcHostEEPROMFile);
+        return;
+    }
+
+    fwrite(g_pui32HostEEPROM, 1, sizeof(g_pui32HostEEPROM), psFile);
+    fclose(psFile);
+}
+
+//*****************************************************************************
+//
+// EEPROM API.
+//
+//*****************************************************************************
+uint32_t
+EEPROMInit(void)
+{
+    FILE *psFile;
+
+    HostLock();
+
+    if(!g_bHostEEPROMLoaded)
+    {
+        g_bHostEEPROMLoaded = true;
+        memset(g_pui32HostEEPROM, 0xff, sizeof(g_pui32HostEEPROM));
+
+        g_pcHostEEPROMFile = getenv("HOST_EEPROM");
+        if(g_pcHostEEPROMFile && !*g_pcHostEEPROMFile)
+        {
+            g_pcHostEEPROMFile = 0;
+        }
+
+        psFile = g_pcHostEEPROMFile ? fopen(g_pcHostEEPROMFile, "rb") : 0;
+        if(psFile)
+        {
+            if(fread(g_pui32HostEEPROM, 1, sizeof(g_pui32HostEEPROM),
+                     psFile) != sizeof(g_pui32HostEEPROM))
+            {
+                memset(g_pui32HostEEPROM, 0xff, sizeof(g_pui32HostEEPROM));
+            }
+            fclose(psFile);
+        }
+    }
+
+    HostUnlock();
+
+    return(EEPROM_INIT_OK);
+}
+
+uint32_t
+EEPROMSizeGet(void)
+{
+    return(HOST_EEPROM_SIZE);
+}
+
+uint32_t
+EEPROMBlockCountGet(void)
+{
+    return(HOST_EEPROM_BLOCKS);
+}
+
+void
+EEPROMRead(uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    if(((ui32Address | ui32Count) & 3) ||
+       ((ui32Address + ui32Count) > HOST_EEPROM_SIZE))
+    {
+        fprintf(stderr, "host: EEPROMRead out of range at 0x%x\n",
+                (unsigned int)ui32Address);
+        abort();
+    }
+
+    HostLock();
+    memcpy(pui32Data, &g_pui32HostEEPROM[ui32Address / 4], ui32Count);
+    HostUnlock();
+}
+
+uint32_t
+EEPROMProgram(uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    uint32_t ui32Word;
+
+    if(((ui32Address | ui32Count) & 3) ||
+       ((ui32Address + ui32Count) > HOST_EEPROM_SIZE))
+    {
+        fprintf(stderr, "host: EEPROMProgram out of range at 0x%x\n",
+                (unsigned int)ui32Address);
+        abort();
+    }
+
+    HostLock();
+
+    for(ui32Word = 0; ui32Word < (ui32Count / 4); ui32Word++)
+    {
+        g_pui32HostEEPROM[(ui32Address / 4) + ui32Word] = pui32Data[ui32Word];
+    }
+    HostEEPROMStore();
+
+    HostUnlock();
+
+    return(0);
+}
+
+uint32_t
+EEPROMMassErase(void)
+{
+    HostLock();
+
+    memset(g_pui32HostEEPROM, 0xff, sizeof(g_pui32HostEEPROM));
+    HostEEPROMStore();
+
+    HostUnlock();
+
+    return(0);
+}
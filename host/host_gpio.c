@@ -0,0 +1,313 @@
+//*****************************************************************************
+//
+// host_gpio.c - GPIO model of the host build hardware shim.
+//
+// Outputs are only remembered.  Inputs follow their pad pull, or the level
+// set by HostGPIOInput(), and raise edge and level interrupts.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "host.h"
+
+//*****************************************************************************
+//
+// The state of one GPIO port.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Base;
+    uint32_t ui32Int;
+    uint8_t ui8Dir;
+    uint8_t ui8Data;
+    uint8_t ui8PullUp;
+    uint8_t ui8Driven;
+    uint8_t ui8Input;
+    uint8_t ui8IS;
+    uint8_t ui8IBE;
+    uint8_t ui8IEV;
+    uint8_t ui8IM;
+    uint8_t ui8RIS;
+}
+tHostGPIO;
+
+static tHostGPIO g_psHostGPIO[] =
+{
+    { GPIO_PORTA_BASE, INT_GPIOA },
+    { GPIO_PORTB_BASE, INT_GPIOB },
+    { GPIO_PORTC_BASE, INT_GPIOC },
+    { GPIO_PORTD_BASE, INT_GPIOD },
+    { GPIO_PORTE_BASE, INT_GPIOE },
+    { GPIO_PORTF_BASE, INT_GPIOF },
+};
+
+#define NUM_HOST_GPIOS          (sizeof(g_psHostGPIO) / sizeof(g_psHostGPIO[0]))
+
+//*****************************************************************************
+//
+// Look up a port by base address.
+//
+//*****************************************************************************
+static tHostGPIO *
+HostGPIOGet(uint32_t ui32Port)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_HOST_GPIOS; ui32Index++)
+    {
+        if(g_psHostGPIO[ui32Index].ui32Base == ui32Port)
+        {
+            return(&g_psHostGPIO[ui32Index]);
+        }
+    }
+
+    fprintf(stderr, "host: no GPIO port at 0x%08x\n", ui32Port);
+    abort();
+}
+
+//*****************************************************************************
+//
+// The level seen on the input pins: the driven level where one was set,
+// otherwise the pad pull.
+//
+//*****************************************************************************
+static uint8_t
+HostGPIOLevel(tHostGPIO *psGPIO)
+{
+    return((psGPIO->ui8Input & psGPIO->ui8Driven) |
+           (psGPIO->ui8PullUp & ~psGPIO->ui8Driven));
+}
+
+//*****************************************************************************
+//
+// Raise the interrupts caused by a change of the input level, and keep level
+// interrupts asserted while their level holds.  Called with the lock held.
+//
+//*****************************************************************************
+static void
+HostGPIOUpdate(tHostGPIO *psGPIO, uint8_t ui8Old)
+{
+    uint8_t ui8New;
+    uint8_t ui8Rise;
+    uint8_t ui8Fall;
+    uint8_t ui8Edge;
+
+    ui8New = HostGPIOLevel(psGPIO);
+    ui8Rise = ~ui8Old & ui8New;
+    ui8Fall = ui8Old & ~ui8New;
+
+    ui8Edge = (psGPIO->ui8IBE & (ui8Rise | ui8Fall)) |
+              (~psGPIO->ui8IBE & psGPIO->ui8IEV & ui8Rise) |
+              (~psGPIO->ui8IBE & ~psGPIO->ui8IEV & ui8Fall);
+
+    psGPIO->ui8RIS |= ~psGPIO->ui8IS & ~psGPIO->ui8Dir & ui8Edge;
+    psGPIO->ui8RIS |= psGPIO->ui8IS & ~psGPIO->ui8Dir &
+                      ~(ui8New ^ psGPIO->ui8IEV);
+
+    if(psGPIO->ui8RIS & psGPIO->ui8IM)
+    {
+        HostIntPend(psGPIO->ui32Int);
+    }
+}
+
+//*****************************************************************************
+//
+// Drive input pins from outside, as a button or another chip would.
+//
+//*****************************************************************************
+void
+HostGPIOInput(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    tHostGPIO *psGPIO;
+    uint8_t ui8Old;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    ui8Old = HostGPIOLevel(psGPIO);
+    psGPIO->ui8Driven |= ui8Pins;
+    psGPIO->ui8Input = (psGPIO->ui8Input & ~ui8Pins) | (ui8Val & ui8Pins);
+    HostGPIOUpdate(psGPIO, ui8Old);
+    HostUnlock();
+}
+
+//*****************************************************************************
+//
+// GPIO API.
+//
+//*****************************************************************************
+void
+GPIODirModeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32PinIO)
+{
+    tHostGPIO *psGPIO;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    if(ui32PinIO == GPIO_DIR_MODE_OUT)
+    {
+        psGPIO->ui8Dir |= ui8Pins;
+    }
+    else
+    {
+        psGPIO->ui8Dir &= ~ui8Pins;
+    }
+    HostUnlock();
+}
+
+void
+GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength,
+                 uint32_t ui32PadType)
+{
+    tHostGPIO *psGPIO;
+    uint8_t ui8Old;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    ui8Old = HostGPIOLevel(psGPIO);
+    if(ui32PadType == GPIO_PIN_TYPE_STD_WPU)
+    {
+        psGPIO->ui8PullUp |= ui8Pins;
+    }
+    else
+    {
+        psGPIO->ui8PullUp &= ~ui8Pins;
+    }
+    HostGPIOUpdate(psGPIO, ui8Old);
+    HostUnlock();
+}
+
+void
+GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+}
+
+void
+GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    GPIODirModeSet(ui32Port, ui8Pins, GPIO_DIR_MODE_IN);
+}
+
+void
+GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    GPIODirModeSet(ui32Port, ui8Pins, GPIO_DIR_MODE_OUT);
+}
+
+void
+GPIOPinTypeTimer(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    GPIODirModeSet(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+void
+GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    GPIODirModeSet(ui32Port, ui8Pins, GPIO_DIR_MODE_HW);
+}
+
+int32_t
+GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    tHostGPIO *psGPIO;
+    uint8_t ui8Val;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    ui8Val = (psGPIO->ui8Data & psGPIO->ui8Dir) |
+             (HostGPIOLevel(psGPIO) & ~psGPIO->ui8Dir);
+    HostUnlock();
+
+    return(ui8Val & ui8Pins);
+}
+
+void
+GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    tHostGPIO *psGPIO;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    psGPIO->ui8Data = (psGPIO->ui8Data & ~ui8Pins) | (ui8Val & ui8Pins);
+    HostUnlock();
+}
+
+void
+GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType)
+{
+    tHostGPIO *psGPIO;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    psGPIO->ui8IBE = (ui32IntType & GPIO_BOTH_EDGES) ?
+                     (psGPIO->ui8IBE | ui8Pins) : (psGPIO->ui8IBE & ~ui8Pins);
+    psGPIO->ui8IS = (ui32IntType & GPIO_LOW_LEVEL) ?
+                    (psGPIO->ui8IS | ui8Pins) : (psGPIO->ui8IS & ~ui8Pins);
+    psGPIO->ui8IEV = (ui32IntType & GPIO_RISING_EDGE) ?
+                     (psGPIO->ui8IEV | ui8Pins) : (psGPIO->ui8IEV & ~ui8Pins);
+    HostUnlock();
+}
+
+void
+GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    tHostGPIO *psGPIO;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    psGPIO->ui8IM |= ui32IntFlags;
+    HostGPIOUpdate(psGPIO, HostGPIOLevel(psGPIO));
+    HostUnlock();
+}
+
+void
+GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    HostLock();
+    HostGPIOGet(ui32Port)->ui8IM &= ~ui32IntFlags;
+    HostUnlock();
+}
+
+uint32_t
+GPIOIntStatus(uint32_t ui32Port, bool bMasked)
+{
+    tHostGPIO *psGPIO;
+    uint32_t ui32Status;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    ui32Status = psGPIO->ui8RIS;
+    if(bMasked)
+    {
+        ui32Status &= psGPIO->ui8IM;
+    }
+    HostUnlock();
+
+    return(ui32Status);
+}
+
+void
+GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+    tHostGPIO *psGPIO;
+
+    psGPIO = HostGPIOGet(ui32Port);
+
+    HostLock();
+    psGPIO->ui8RIS &= ~ui32IntFlags;
+    HostGPIOUpdate(psGPIO, HostGPIOLevel(psGPIO));
+    HostUnlock();
+}
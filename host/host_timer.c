@@ -0,0 +1,473 @@
+//*****************************************************************************
+//
+// host_timer.c - General purpose timer model of the host build hardware
+//                shim.
+//
+// Periodic and one-shot down counters clocked from the system clock.  Each
+// timer half counts on its own; a full width configuration uses half A.  The
+// SysTick counter is modelled here too, as a periodic counter of its own.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+#include "host.h"
+
+//*****************************************************************************
+//
+// The state of one timer half.
+//
+//*****************************************************************************
+typedef struct
+{
+    bool bEnabled;
+    bool bPeriodic;
+    uint64_t ui64Load;
+    uint64_t ui64Start;
+    uint64_t ui64Deadline;
+}
+tHostTimerHalf;
+
+typedef struct
+{
+    uint32_t ui32Base;
+    uint32_t pui32Int[2];
+    uint32_t ui32RIS;
+    uint32_t ui32IM;
+    tHostTimerHalf psHalf[2];
+}
+tHostTimer;
+
+static tHostTimer g_psHostTimer[] =
+{
+    { TIMER0_BASE, { INT_TIMER0A, INT_TIMER0B } },
+    { TIMER1_BASE, { INT_TIMER1A, INT_TIMER1B } },
+    { TIMER2_BASE, { INT_TIMER2A, INT_TIMER2B } },
+    { WTIMER5_BASE, { INT_WTIMER5A, INT_WTIMER5B } },
+};
+
+#define NUM_HOST_TIMERS         (sizeof(g_psHostTimer) /                      \
+                                 sizeof(g_psHostTimer[0]))
+
+//*****************************************************************************
+//
+// The SysTick counter.  It reloads from the period register, which holds one
+// less than the number of clocks per tick.
+//
+//*****************************************************************************
+static bool g_bSysTickIntEnabled;
+static tHostTimerHalf g_sSysTick = { false, true, 0xffffff };
+
+//*****************************************************************************
+//
+// The timeout flag of each half.
+//
+//*****************************************************************************
+static const uint32_t g_pui32HostTimerFlag[2] =
+{
+    TIMER_TIMA_TIMEOUT, TIMER_TIMB_TIMEOUT
+};
+
+//*****************************************************************************
+//
+// Look up a timer by base address.
+//
+//*****************************************************************************
+static tHostTimer *
+HostTimerGet(uint32_t ui32Base)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_HOST_TIMERS; ui32Index++)
+    {
+        if(g_psHostTimer[ui32Index].ui32Base == ui32Base)
+        {
+            return(&g_psHostTimer[ui32Index]);
+        }
+    }
+
+    fprintf(stderr, "host: no timer at 0x%08x\n", ui32Base);
+    abort();
+}
+
+//*****************************************************************************
+//
+// The time a half takes to count down from its load value.
+//
+//*****************************************************************************
+static uint64_t
+HostTimerPeriod(tHostTimerHalf *psHalf)
+{
+    return(((psHalf->ui64Load + 1) * 1000000000ull) / g_ui32HostClock);
+}
+
+//*****************************************************************************
+//
+// Fire the halves whose time has come and sleep until the next one.
+//
+//*****************************************************************************
+static void *
+HostTimerThread(void *pvArg)
+{
+    tHostTimerHalf *psHalf;
+    uint32_t ui32Timer;
+    uint32_t ui32Half;
+    uint64_t ui64Now;
+    uint64_t ui64Deadline;
+
+    HostLock();
+
+    while(1)
+    {
+        ui64Now = HostNow();
+        ui64Deadline = 0;
+
+        for(ui32Timer = 0; ui32Timer < NUM_HOST_TIMERS; ui32Timer++)
+        {
+            for(ui32Half = 0; ui32Half < 2; ui32Half++)
+            {
+                psHalf = &g_psHostTimer[ui32Timer].psHalf[ui32Half];
+
+                if(!psHalf->bEnabled)
+                {
+                    continue;
+                }
+
+                if(ui64Now >= psHalf->ui64Deadline)
+                {
+                    g_psHostTimer[ui32Timer].ui32RIS |=
+                        g_pui32HostTimerFlag[ui32Half];
+
+                    if(g_psHostTimer[ui32Timer].ui32IM &
+                       g_pui32HostTimerFlag[ui32Half])
+                    {
+                        HostIntPend(g_psHostTimer[ui32Timer].pui32Int[ui32Half]);
+                    }
+
+                    if(psHalf->bPeriodic)
+                    {
+                        psHalf->ui64Start = psHalf->ui64Deadline;
+                        psHalf->ui64Deadline += HostTimerPeriod(psHalf);
+                    }
+                    else
+                    {
+                        psHalf->bEnabled = false;
+                        continue;
+                    }
+                }
+
+                if(!ui64Deadline || (psHalf->ui64Deadline < ui64Deadline))
+                {
+                    ui64Deadline = psHalf->ui64Deadline;
+                }
+            }
+        }
+
+        if(g_sSysTick.bEnabled)
+        {
+            if(ui64Now >= g_sSysTick.ui64Deadline)
+            {
+                if(g_bSysTickIntEnabled)
+                {
+                    HostIntPend(FAULT_SYSTICK);
+                }
+
+                g_sSysTick.ui64Start = g_sSysTick.ui64Deadline;
+                g_sSysTick.ui64Deadline += HostTimerPeriod(&g_sSysTick);
+            }
+
+            if(!ui64Deadline || (g_sSysTick.ui64Deadline < ui64Deadline))
+            {
+                ui64Deadline = g_sSysTick.ui64Deadline;
+            }
+        }
+
+        HostWait(ui64Deadline);
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Carry a running half on at a new system clock rate.  The count reached so
+// far is kept, and the rest of the count runs at the new rate.  Called with
+// the lock held.
+//
+//*****************************************************************************
+static void
+HostTimerRescale(tHostTimerHalf *psHalf, uint64_t ui64Now, uint32_t ui32OldHz,
+                 uint32_t ui32NewHz)
+{
+    uint64_t ui64Elapsed;
+
+    if(!psHalf->bEnabled)
+    {
+        return;
+    }
+
+    ui64Elapsed = ((ui64Now - psHalf->ui64Start) * ui32OldHz) / 1000000000ull;
+    psHalf->ui64Start = ui64Now - ((ui64Elapsed * 1000000000ull) / ui32NewHz);
+    psHalf->ui64Deadline = psHalf->ui64Start +
+                           (((psHalf->ui64Load + 1) * 1000000000ull) /
+                            ui32NewHz);
+}
+
+void
+HostTimerClockSet(uint64_t ui64Now, uint32_t ui32OldHz, uint32_t ui32NewHz)
+{
+    uint32_t ui32Timer;
+
+    for(ui32Timer = 0; ui32Timer < NUM_HOST_TIMERS; ui32Timer++)
+    {
+        HostTimerRescale(&g_psHostTimer[ui32Timer].psHalf[0], ui64Now,
+                         ui32OldHz, ui32NewHz);
+        HostTimerRescale(&g_psHostTimer[ui32Timer].psHalf[1], ui64Now,
+                         ui32OldHz, ui32NewHz);
+    }
+
+    HostTimerRescale(&g_sSysTick, ui64Now, ui32OldHz, ui32NewHz);
+}
+
+void
+HostTimerStart(void)
+{
+    pthread_t sThread;
+
+    pthread_create(&sThread, 0, HostTimerThread, 0);
+}
+
+//*****************************************************************************
+//
+// Timer API.
+//
+//*****************************************************************************
+void
+TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+    tHostTimer *psTimer;
+
+    psTimer = HostTimerGet(ui32Base);
+
+    HostLock();
+    psTimer->psHalf[0].bEnabled = false;
+    psTimer->psHalf[1].bEnabled = false;
+    psTimer->psHalf[0].bPeriodic = (ui32Config & 0xff) != 0x21;
+    psTimer->psHalf[1].bPeriodic = ((ui32Config >> 8) & 0xff) != 0x21;
+    HostUnlock();
+}
+
+void
+TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    tHostTimer *psTimer;
+    uint32_t ui32Half;
+
+    psTimer = HostTimerGet(ui32Base);
+
+    HostLock();
+    for(ui32Half = 0; ui32Half < 2; ui32Half++)
+    {
+        if(ui32Timer & (0xff << (ui32Half * 8)))
+        {
+            psTimer->psHalf[ui32Half].bEnabled = true;
+            psTimer->psHalf[ui32Half].ui64Start = HostNow();
+            psTimer->psHalf[ui32Half].ui64Deadline =
+                psTimer->psHalf[ui32Half].ui64Start +
+                HostTimerPeriod(&psTimer->psHalf[ui32Half]);
+        }
+    }
+    HostSignal();
+    HostUnlock();
+}
+
+void
+TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    tHostTimer *psTimer;
+
+    psTimer = HostTimerGet(ui32Base);
+
+    HostLock();
+    if(ui32Timer & TIMER_A)
+    {
+        psTimer->psHalf[0].bEnabled = false;
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        psTimer->psHalf[1].bEnabled = false;
+    }
+    HostUnlock();
+}
+
+void
+TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    tHostTimer *psTimer;
+
+    psTimer = HostTimerGet(ui32Base);
+
+    HostLock();
+    if(ui32Timer & TIMER_A)
+    {
+        psTimer->psHalf[0].ui64Load = ui32Value;
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        psTimer->psHalf[1].ui64Load = ui32Value;
+    }
+    HostUnlock();
+}
+
+void
+TimerLoadSet64(uint32_t ui32Base, uint64_t ui64Value)
+{
+    HostLock();
+    HostTimerGet(ui32Base)->psHalf[0].ui64Load = ui64Value;
+    HostUnlock();
+}
+
+uint32_t
+TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    tHostTimerHalf *psHalf;
+    uint64_t ui64Elapsed;
+    uint32_t ui32Value;
+
+    psHalf = &HostTimerGet(ui32Base)->psHalf[(ui32Timer & TIMER_A) ? 0 : 1];
+
+    HostLock();
+    ui64Elapsed = ((HostNow() - psHalf->ui64Start) * g_ui32HostClock) /
+                  1000000000ull;
+    ui32Value = (ui64Elapsed > psHalf->ui64Load) ?
+                0 : (uint32_t)(psHalf->ui64Load - ui64Elapsed);
+    HostUnlock();
+
+    return(ui32Value);
+}
+
+void
+TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+}
+
+void
+TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostLock();
+    HostTimerGet(ui32Base)->ui32IM |= ui32IntFlags;
+    HostUnlock();
+}
+
+void
+TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostLock();
+    HostTimerGet(ui32Base)->ui32IM &= ~ui32IntFlags;
+    HostUnlock();
+}
+
+uint32_t
+TimerIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    tHostTimer *psTimer;
+    uint32_t ui32Status;
+
+    psTimer = HostTimerGet(ui32Base);
+
+    HostLock();
+    ui32Status = psTimer->ui32RIS;
+    if(bMasked)
+    {
+        ui32Status &= psTimer->ui32IM;
+    }
+    HostUnlock();
+
+    return(ui32Status);
+}
+
+void
+TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostLock();
+    HostTimerGet(ui32Base)->ui32RIS &= ~ui32IntFlags;
+    HostUnlock();
+}
+
+//*****************************************************************************
+//
+// SysTick API.
+//
+//*****************************************************************************
+void
+SysTickEnable(void)
+{
+    HostLock();
+    g_sSysTick.bEnabled = true;
+    g_sSysTick.ui64Start = HostNow();
+    g_sSysTick.ui64Deadline = g_sSysTick.ui64Start +
+                              HostTimerPeriod(&g_sSysTick);
+    HostSignal();
+    HostUnlock();
+}
+
+void
+SysTickDisable(void)
+{
+    HostLock();
+    g_sSysTick.bEnabled = false;
+    HostUnlock();
+}
+
+void
+SysTickIntEnable(void)
+{
+    HostLock();
+    g_bSysTickIntEnabled = true;
+    HostUnlock();
+}
+
+void
+SysTickIntDisable(void)
+{
+    HostLock();
+    g_bSysTickIntEnabled = false;
+    HostUnlock();
+}
+
+void
+SysTickPeriodSet(uint32_t ui32Period)
+{
+    HostLock();
+    g_sSysTick.ui64Load = (ui32Period - 1) & 0xffffff;
+    HostUnlock();
+}
+
+uint32_t
+SysTickPeriodGet(void)
+{
+    return((uint32_t)g_sSysTick.ui64Load + 1);
+}
+
+uint32_t
+SysTickValueGet(void)
+{
+    uint64_t ui64Elapsed;
+    uint32_t ui32Value;
+
+    HostLock();
+    ui64Elapsed = ((HostNow() - g_sSysTick.ui64Start) * g_ui32HostClock) /
+                  1000000000ull;
+    ui32Value = (uint32_t)(g_sSysTick.ui64Load -
+                           (ui64Elapsed % (g_sSysTick.ui64Load + 1)));
+    HostUnlock();
+
+    return(ui32Value);
+}
@@ -0,0 +1,1336 @@
+//*****************************************************************************
+//
+// host_uart.c - UART and uDMA models of the host build hardware shim.
+//
+// Each UART is backed by a host file descriptor chosen with the HOST_UARTn
+// environment variable:
+//
+//   stdio      standard input and output, in raw mode if they are a terminal
+//   pty        a new pseudo terminal whose path is printed on stderr
+//   null       nothing is received and everything sent is discarded
+//   <path>     any other value is opened as a file, fifo or tty
+//
+// UART0 defaults to stdio and the other UARTs to pty.  Bytes move through
+// 16 byte FIFOs at the configured baud rate unless HOST_PACING=0, so the
+// firmware sees the same interrupt and DMA timing it would on the board.
+// When standard input reaches end of file the program exits once the
+// console has been quiet for HOST_LINGER_MS milliseconds (default 2000).
+//
+//*****************************************************************************
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <termios.h>
+#include <unistd.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "host.h"
+
+//*****************************************************************************
+//
+// The depth of the UART FIFOs.
+//
+//*****************************************************************************
+#define UART_FIFO_SIZE          16
+
+//*****************************************************************************
+//
+// The state of one UART.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Base;
+    uint32_t ui32Int;
+    const char *pcName;
+    const char *pcDefault;
+
+    //
+    // The host side of the line.
+    //
+    bool bOpen;
+    bool bConsole;
+    int iRxFd;
+    int iTxFd;
+
+    //
+    // Line configuration.  The divisor is kept in 64ths, as in the IBRD and
+    // FBRD registers, so that changing the system clock changes the baud
+    // rate just as it does on the board, unless the UART is clocked from the
+    // 16 MHz PIOSC.
+    //
+    bool bEnabled;
+    bool bPIOSC;
+    uint32_t ui32Divisor;
+    uint32_t ui32FIFOLevel;
+    uint32_t ui32FlowControl;
+    uint32_t ui32DMAControl;
+
+    //
+    // Interrupt state.
+    //
+    uint32_t ui32RIS;
+    uint32_t ui32IM;
+    bool bTimeoutArmed;
+    uint64_t ui64LastRx;
+
+    //
+    // FIFOs.
+    //
+    uint8_t pui8RxFIFO[UART_FIFO_SIZE];
+    uint32_t ui32RxRead;
+    uint32_t ui32RxCount;
+    uint8_t pui8TxFIFO[UART_FIFO_SIZE];
+    uint32_t ui32TxRead;
+    uint32_t ui32TxCount;
+    uint64_t ui64NextTx;
+
+    //
+    // Set once the console input reaches end of file.
+    //
+    bool bEOF;
+    uint64_t ui64LastActivity;
+}
+tHostUART;
+
+static tHostUART g_psHostUART[] =
+{
+    { UART0_BASE, INT_UART0, "HOST_UART0", "stdio" },
+    { UART1_BASE, INT_UART1, "HOST_UART1", "pty" },
+    { UART5_BASE, INT_UART5, "HOST_UART5", "pty" },
+};
+
+#define NUM_HOST_UARTS          (sizeof(g_psHostUART) / sizeof(g_psHostUART[0]))
+
+//*****************************************************************************
+//
+// The state of one uDMA channel.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Control;
+    uint32_t ui32Mode;
+    uint8_t *pui8Src;
+    uint8_t *pui8Dst;
+    uint32_t ui32Size;
+    uint32_t ui32Remaining;
+}
+tHostDMAControl;
+
+typedef struct
+{
+    bool bEnabled;
+    uint32_t ui32Attr;
+    uint32_t ui32Assign;
+    tHostDMAControl psControl[2];
+}
+tHostDMAChannel;
+
+static tHostDMAChannel g_psHostDMA[32];
+static bool g_bHostDMAEnabled;
+
+//*****************************************************************************
+//
+// The channel assignments this shim knows about, as encoded in the
+// UDMA_CHn_xxx mapping values.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Mapping;
+    uint32_t ui32Base;
+    bool bRx;
+}
+tHostDMAMap;
+
+static const tHostDMAMap g_psHostDMAMap[] =
+{
+    { UDMA_CH8_UART0RX, UART0_BASE, true },
+    { UDMA_CH9_UART0TX, UART0_BASE, false },
+    { 0x00010008, UART1_BASE, true },
+    { 0x00010009, UART1_BASE, false },
+    { UDMA_CH22_UART1RX, UART1_BASE, true },
+    { UDMA_CH23_UART1TX, UART1_BASE, false },
+    { UDMA_CH6_UART5RX, UART5_BASE, true },
+    { UDMA_CH7_UART5TX, UART5_BASE, false },
+};
+
+#define NUM_HOST_DMA_MAP        (sizeof(g_psHostDMAMap) /                     \
+                                 sizeof(g_psHostDMAMap[0]))
+
+//*****************************************************************************
+//
+// Shim options read from the environment.
+//
+//*****************************************************************************
+static bool g_bHostPacing = true;
+static uint64_t g_ui64HostLingerNs = 2000000000ull;
+static struct termios g_sHostConsoleTermios;
+static bool g_bHostConsoleRaw;
+
+//*****************************************************************************
+//
+// FIFO trigger levels in bytes, indexed by the UART_FIFO_xXn_8 encoding.
+//
+//*****************************************************************************
+static const uint32_t g_pui32HostFIFOLevel[] = { 2, 4, 8, 12, 14, 14, 14, 14 };
+
+//*****************************************************************************
+//
+// Look up a UART by base address.
+//
+//*****************************************************************************
+static tHostUART *
+HostUARTGet(uint32_t ui32Base)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_HOST_UARTS; ui32Index++)
+    {
+        if(g_psHostUART[ui32Index].ui32Base == ui32Base)
+        {
+            return(&g_psHostUART[ui32Index]);
+        }
+    }
+
+    fprintf(stderr, "host: no UART at 0x%08x\n", ui32Base);
+    abort();
+}
+
+//*****************************************************************************
+//
+// The time one character takes on the line, start and stop bits included.
+//
+//*****************************************************************************
+static uint64_t
+HostUARTCharTime(tHostUART *psUART)
+{
+    uint64_t ui64Baud;
+
+    if(!g_bHostPacing || !psUART->ui32Divisor)
+    {
+        return(0);
+    }
+
+    ui64Baud = ((uint64_t)(psUART->bPIOSC ? 16000000 : g_ui32HostClock) * 4) /
+               psUART->ui32Divisor;
+    if(!ui64Baud)
+    {
+        ui64Baud = 1;
+    }
+
+    return(10000000000ull / ui64Baud);
+}
+
+//*****************************************************************************
+//
+// Find the UART and direction served by a uDMA channel, if the channel is
+// enabled and the UART has requests for that direction turned on.
+//
+//*****************************************************************************
+static tHostDMAChannel *
+HostDMAChannelFor(tHostUART *psUART, bool bRx, uint32_t *pui32Channel)
+{
+    uint32_t ui32Index;
+    uint32_t ui32Channel;
+    tHostDMAChannel *psChannel;
+
+    if(!g_bHostDMAEnabled ||
+       !(psUART->ui32DMAControl & (bRx ? UART_DMA_RX : UART_DMA_TX)))
+    {
+        return(0);
+    }
+
+    for(ui32Index = 0; ui32Index < NUM_HOST_DMA_MAP; ui32Index++)
+    {
+        if((g_psHostDMAMap[ui32Index].ui32Base != psUART->ui32Base) ||
+           (g_psHostDMAMap[ui32Index].bRx != bRx))
+        {
+            continue;
+        }
+
+        ui32Channel = g_psHostDMAMap[ui32Index].ui32Mapping & 0x1f;
+        psChannel = &g_psHostDMA[ui32Channel];
+
+        if((psChannel->ui32Assign ==
+            (g_psHostDMAMap[ui32Index].ui32Mapping >> 16)) &&
+           psChannel->bEnabled &&
+           !(psChannel->ui32Attr & UDMA_ATTR_REQMASK))
+        {
+            *pui32Channel = ui32Channel;
+            return(psChannel);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// The number of items moved per burst request.
+//
+//*****************************************************************************
+static uint32_t
+HostDMAArbSize(tHostDMAControl *psControl)
+{
+    return(1 << ((psControl->ui32Control >> 14) & 0xf));
+}
+
+//*****************************************************************************
+//
+// Finish the active control structure of a channel.  In ping-pong mode the
+// controller moves on to the other structure; otherwise, or if that one is
+// stopped too, the channel is disabled.  Completion is signalled on the
+// interrupt of the peripheral, as on the TM4C123.
+//
+//*****************************************************************************
+static void
+HostDMAComplete(tHostUART *psUART, tHostDMAChannel *psChannel)
+{
+    uint32_t ui32Alt;
+
+    ui32Alt = (psChannel->ui32Attr & UDMA_ATTR_ALTSELECT) ? 1 : 0;
+
+    if(psChannel->psControl[ui32Alt].ui32Mode == UDMA_MODE_PINGPONG)
+    {
+        psChannel->psControl[ui32Alt].ui32Mode = UDMA_MODE_STOP;
+        psChannel->ui32Attr ^= UDMA_ATTR_ALTSELECT;
+
+        if(psChannel->psControl[ui32Alt ^ 1].ui32Mode == UDMA_MODE_STOP)
+        {
+            psChannel->bEnabled = false;
+        }
+    }
+    else
+    {
+        psChannel->psControl[ui32Alt].ui32Mode = UDMA_MODE_STOP;
+        psChannel->bEnabled = false;
+    }
+
+    HostIntPend(psUART->ui32Int);
+}
+
+//*****************************************************************************
+//
+// Run the DMA requests of a UART and update its interrupt lines.  Called
+// with the lock held whenever a FIFO, a channel or a mask changes.
+//
+//*****************************************************************************
+static void
+HostUARTService(tHostUART *psUART)
+{
+    tHostDMAChannel *psChannel;
+    tHostDMAControl *psControl;
+    uint32_t ui32Channel;
+    uint32_t ui32Count;
+    uint32_t ui32Level;
+
+    //
+    // Receive requests.  With USEBURST set only a burst request is made,
+    // which needs the FIFO at its trigger level.
+    //
+    while((psChannel = HostDMAChannelFor(psUART, true, &ui32Channel)) != 0)
+    {
+        psControl = &psChannel->psControl[(psChannel->ui32Attr &
+                                           UDMA_ATTR_ALTSELECT) ? 1 : 0];
+
+        if(psControl->ui32Mode == UDMA_MODE_STOP)
+        {
+            psChannel->bEnabled = false;
+            break;
+        }
+
+        ui32Level = g_pui32HostFIFOLevel[(psUART->ui32FIFOLevel >> 3) & 7];
+        if((psChannel->ui32Attr & UDMA_ATTR_USEBURST) ?
+           (psUART->ui32RxCount < ui32Level) : (psUART->ui32RxCount == 0))
+        {
+            break;
+        }
+
+        ui32Count = psUART->ui32RxCount;
+        if(psChannel->ui32Attr & UDMA_ATTR_USEBURST)
+        {
+            ui32Count = HostDMAArbSize(psControl);
+        }
+        if(ui32Count > psControl->ui32Remaining)
+        {
+            ui32Count = psControl->ui32Remaining;
+        }
+
+        while(ui32Count--)
+        {
+            psControl->pui8Dst[psControl->ui32Size -
+                               psControl->ui32Remaining] =
+                psUART->pui8RxFIFO[psUART->ui32RxRead];
+            psUART->ui32RxRead = (psUART->ui32RxRead + 1) % UART_FIFO_SIZE;
+            psUART->ui32RxCount--;
+            psControl->ui32Remaining--;
+        }
+
+        if(psControl->ui32Remaining == 0)
+        {
+            HostDMAComplete(psUART, psChannel);
+        }
+    }
+
+    //
+    // Transmit requests.
+    //
+    while((psChannel = HostDMAChannelFor(psUART, false, &ui32Channel)) != 0)
+    {
+        psControl = &psChannel->psControl[(psChannel->ui32Attr &
+                                           UDMA_ATTR_ALTSELECT) ? 1 : 0];
+
+        if(psControl->ui32Mode == UDMA_MODE_STOP)
+        {
+            psChannel->bEnabled = false;
+            break;
+        }
+
+        ui32Count = UART_FIFO_SIZE - psUART->ui32TxCount;
+        if((psChannel->ui32Attr & UDMA_ATTR_USEBURST) &&
+           (ui32Count < HostDMAArbSize(psControl)))
+        {
+            break;
+        }
+        if(ui32Count == 0)
+        {
+            break;
+        }
+        if(ui32Count > psControl->ui32Remaining)
+        {
+            ui32Count = psControl->ui32Remaining;
+        }
+
+        while(ui32Count--)
+        {
+            psUART->pui8TxFIFO[(psUART->ui32TxRead + psUART->ui32TxCount) %
+                               UART_FIFO_SIZE] =
+                psControl->pui8Src[psControl->ui32Size -
+                                   psControl->ui32Remaining];
+            psUART->ui32TxCount++;
+            psControl->ui32Remaining--;
+        }
+
+        if(psControl->ui32Remaining == 0)
+        {
+            HostDMAComplete(psUART, psChannel);
+        }
+    }
+
+    //
+    // FIFO level interrupts follow the FIFO contents.
+    //
+    ui32Level = g_pui32HostFIFOLevel[(psUART->ui32FIFOLevel >> 3) & 7];
+    if(psUART->ui32RxCount >= ui32Level)
+    {
+        psUART->ui32RIS |= UART_INT_RX;
+    }
+    else
+    {
+        psUART->ui32RIS &= ~UART_INT_RX;
+    }
+
+    ui32Level = g_pui32HostFIFOLevel[psUART->ui32FIFOLevel & 7];
+    if(psUART->ui32TxCount <= (UART_FIFO_SIZE - ui32Level))
+    {
+        psUART->ui32RIS |= UART_INT_TX;
+    }
+    else
+    {
+        psUART->ui32RIS &= ~UART_INT_TX;
+    }
+
+    if(psUART->ui32RxCount == 0)
+    {
+        psUART->ui32RIS &= ~UART_INT_RT;
+        psUART->bTimeoutArmed = false;
+    }
+
+    if(psUART->ui32RIS & psUART->ui32IM)
+    {
+        HostIntPend(psUART->ui32Int);
+    }
+
+    HostSignal();
+}
+
+//*****************************************************************************
+//
+// Put a terminal into raw mode.
+//
+//*****************************************************************************
+static void
+HostTermRaw(int iFd)
+{
+    struct termios sTermios;
+
+    if(tcgetattr(iFd, &sTermios) == 0)
+    {
+        cfmakeraw(&sTermios);
+        tcsetattr(iFd, TCSANOW, &sTermios);
+    }
+}
+
+//*****************************************************************************
+//
+// Set the speed of a terminal to a baud rate, if it has one of that speed.
+// The speed carries no meaning for a pty, but a program at the other end,
+// such as the ESP8266 simulator, can read it to tell whether both ends
+// agree on the rate.
+//
+//*****************************************************************************
+static const struct
+{
+    uint32_t ui32Baud;
+    speed_t sSpeed;
+}
+g_psHostTermSpeeds[] =
+{
+    { 9600, B9600 },
+    { 19200, B19200 },
+    { 38400, B38400 },
+    { 57600, B57600 },
+    { 115200, B115200 },
+    { 230400, B230400 },
+    { 460800, B460800 },
+    { 921600, B921600 },
+};
+
+static void
+HostTermSpeed(int iFd, uint32_t ui32Baud)
+{
+    struct termios sTermios;
+    uint32_t ui32Index;
+
+    for(ui32Index = 0;
+        ui32Index < (sizeof(g_psHostTermSpeeds) /
+                     sizeof(g_psHostTermSpeeds[0]));
+        ui32Index++)
+    {
+        if((g_psHostTermSpeeds[ui32Index].ui32Baud == ui32Baud) &&
+           (tcgetattr(iFd, &sTermios) == 0))
+        {
+            cfsetispeed(&sTermios, g_psHostTermSpeeds[ui32Index].sSpeed);
+            cfsetospeed(&sTermios, g_psHostTermSpeeds[ui32Index].sSpeed);
+            tcsetattr(iFd, TCSANOW, &sTermios);
+            return;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Whether the peer stops sending while the receive FIFO is full.  With RTS
+// flow control the UART holds RTS off then, but only a peer that watches
+// its CTS waits: a file or pipe always does, while a terminal, such as the
+// pty of the ESP8266 simulator, does once it has CRTSCTS set.  Any other
+// peer goes on and the FIFO overruns.
+//
+//*****************************************************************************
+static bool
+HostUARTPeerHeld(tHostUART *psUART)
+{
+    struct termios sTermios;
+
+    if(!(psUART->ui32FlowControl & UART_FLOWCONTROL_RX))
+    {
+        return(false);
+    }
+
+    if(!isatty(psUART->iRxFd) || (tcgetattr(psUART->iRxFd, &sTermios) != 0))
+    {
+        return(true);
+    }
+
+    return((sTermios.c_cflag & CRTSCTS) != 0);
+}
+
+static void
+HostConsoleRestore(void)
+{
+    if(g_bHostConsoleRaw)
+    {
+        tcsetattr(0, TCSANOW, &g_sHostConsoleTermios);
+    }
+}
+
+//*****************************************************************************
+//
+// Connect a UART to its host backend.
+//
+//*****************************************************************************
+static void
+HostUARTOpen(tHostUART *psUART)
+{
+    const char *pcBackend;
+    int iFd;
+
+    psUART->bOpen = true;
+    psUART->iRxFd = -1;
+    psUART->iTxFd = -1;
+
+    pcBackend = getenv(psUART->pcName);
+    if(!pcBackend || !*pcBackend)
+    {
+        pcBackend = psUART->pcDefault;
+    }
+
+    if(!strcmp(pcBackend, "null"))
+    {
+        return;
+    }
+
+    if(!strcmp(pcBackend, "stdio"))
+    {
+        psUART->bConsole = true;
+        psUART->iRxFd = 0;
+        psUART->iTxFd = 1;
+
+        if(isatty(0) && (tcgetattr(0, &g_sHostConsoleTermios) == 0))
+        {
+            g_bHostConsoleRaw = true;
+            atexit(HostConsoleRestore);
+            HostTermRaw(0);
+        }
+
+        return;
+    }
+
+    if(!strcmp(pcBackend, "pty"))
+    {
+        iFd = posix_openpt(O_RDWR | O_NOCTTY);
+        if((iFd < 0) || grantpt(iFd) || unlockpt(iFd))
+        {
+            fprintf(stderr, "host: %s: cannot create a pty\n", psUART->pcName);
+            exit(1);
+        }
+
+        HostTermRaw(iFd);
+
+        //
+        // Hold the slave open so that reads do not fail with EIO while no
+        // one else has it open.
+        //
+        open(ptsname(iFd), O_RDWR | O_NOCTTY);
+
+        fprintf(stderr, "host: %s on %s\n", psUART->pcName, ptsname(iFd));
+        psUART->iRxFd = iFd;
+        psUART->iTxFd = iFd;
+
+        return;
+    }
+
+    iFd = open(pcBackend, O_RDWR | O_NOCTTY);
+    if(iFd < 0)
+    {
+        fprintf(stderr, "host: %s: cannot open %s: %s\n", psUART->pcName,
+                pcBackend, strerror(errno));
+        exit(1);
+    }
+
+    if(isatty(iFd))
+    {
+        HostTermRaw(iFd);
+    }
+
+    psUART->iRxFd = iFd;
+    psUART->iTxFd = iFd;
+}
+
+//*****************************************************************************
+//
+// Receive side of a UART.  Bytes are read from the backend and enter the RX
+// FIFO one character time apart.  If the FIFO is full the byte is lost and
+// the overrun flag raised, unless hardware flow control is on, in which case
+// the sender is held off.
+//
+//*****************************************************************************
+static void *
+HostUARTRxThread(void *pvArg)
+{
+    tHostUART *psUART;
+    uint8_t pui8Buf[64];
+    ssize_t iCount;
+    ssize_t iIndex;
+    uint64_t ui64Next;
+
+    psUART = pvArg;
+    ui64Next = 0;
+
+    while(1)
+    {
+        iCount = read(psUART->iRxFd, pui8Buf, sizeof(pui8Buf));
+
+        if(iCount < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            iCount = 0;
+        }
+
+        if(iCount == 0)
+        {
+            HostLock();
+            psUART->bEOF = true;
+            HostSignal();
+            HostUnlock();
+            return(0);
+        }
+
+        for(iIndex = 0; iIndex < iCount; iIndex++)
+        {
+            HostLock();
+
+            if(ui64Next > HostNow())
+            {
+                HostUnlock();
+                HostSleepUntil(ui64Next);
+                HostLock();
+            }
+
+            while(!psUART->bEnabled ||
+                  ((psUART->ui32RxCount == UART_FIFO_SIZE) &&
+                   (!g_bHostPacing || HostUARTPeerHeld(psUART))))
+            {
+                HostWait(0);
+            }
+
+            if(psUART->ui32RxCount == UART_FIFO_SIZE)
+            {
+                psUART->ui32RIS |= UART_INT_OE;
+            }
+            else
+            {
+                psUART->pui8RxFIFO[(psUART->ui32RxRead +
+                                    psUART->ui32RxCount) % UART_FIFO_SIZE] =
+                    pui8Buf[iIndex];
+                psUART->ui32RxCount++;
+            }
+
+            psUART->ui64LastRx = HostNow();
+            psUART->ui64LastActivity = psUART->ui64LastRx;
+            psUART->bTimeoutArmed = true;
+            ui64Next = psUART->ui64LastRx + HostUARTCharTime(psUART);
+
+            HostUARTService(psUART);
+            HostUnlock();
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Transmit side and timers of a UART.  Drains the TX FIFO one character time
+// per byte, raises the receive timeout after 32 idle bit times, and ends the
+// program once the console input has closed and the output has settled.
+//
+//*****************************************************************************
+static void *
+HostUARTTxThread(void *pvArg)
+{
+    tHostUART *psUART;
+    uint8_t pui8Buf[UART_FIFO_SIZE];
+    uint32_t ui32Count;
+    uint64_t ui64Now;
+    uint64_t ui64Deadline;
+    uint64_t ui64Timeout;
+
+    psUART = pvArg;
+
+    HostLock();
+
+    while(1)
+    {
+        ui64Now = HostNow();
+        ui64Deadline = 0;
+
+        //
+        // Receive timeout.
+        //
+        if(psUART->bTimeoutArmed && psUART->ui32RxCount)
+        {
+            ui64Timeout = psUART->ui64LastRx +
+                          ((HostUARTCharTime(psUART) * 32) / 10);
+
+            if(ui64Now >= ui64Timeout)
+            {
+                psUART->bTimeoutArmed = false;
+                psUART->ui32RIS |= UART_INT_RT;
+                HostUARTService(psUART);
+            }
+            else
+            {
+                ui64Deadline = ui64Timeout;
+            }
+        }
+
+        //
+        // Transmit.  Without pacing the whole FIFO goes at once.
+        //
+        if(psUART->ui32TxCount && (ui64Now >= psUART->ui64NextTx))
+        {
+            ui32Count = g_bHostPacing ? 1 : psUART->ui32TxCount;
+
+            for(ui64Timeout = 0; ui64Timeout < ui32Count; ui64Timeout++)
+            {
+                pui8Buf[ui64Timeout] = psUART->pui8TxFIFO[psUART->ui32TxRead];
+                psUART->ui32TxRead = (psUART->ui32TxRead + 1) %
+                                     UART_FIFO_SIZE;
+            }
+            psUART->ui32TxCount -= ui32Count;
+            psUART->ui64NextTx = ui64Now + HostUARTCharTime(psUART);
+            psUART->ui64LastActivity = ui64Now;
+            HostUARTService(psUART);
+
+            HostUnlock();
+            if(psUART->iTxFd >= 0)
+            {
+                if(write(psUART->iTxFd, pui8Buf, ui32Count) < 0)
+                {
+                    psUART->iTxFd = -1;
+                }
+            }
+            HostLock();
+            continue;
+        }
+
+        if(psUART->ui32TxCount &&
+           (!ui64Deadline || (psUART->ui64NextTx < ui64Deadline)))
+        {
+            ui64Deadline = psUART->ui64NextTx;
+        }
+
+        //
+        // Console end of file.
+        //
+        if(psUART->bEOF && psUART->bConsole && !psUART->ui32TxCount)
+        {
+            ui64Timeout = psUART->ui64LastActivity + g_ui64HostLingerNs;
+
+            if(ui64Now >= ui64Timeout)
+            {
+                exit(0);
+            }
+
+            if(!ui64Deadline || (ui64Timeout < ui64Deadline))
+            {
+                ui64Deadline = ui64Timeout;
+            }
+        }
+
+        HostWait(ui64Deadline);
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Read the shim options.  The backends are opened when the firmware first
+// configures each UART.
+//
+//*****************************************************************************
+void
+HostUARTStart(void)
+{
+    const char *pcValue;
+
+    pcValue = getenv("HOST_PACING");
+    if(pcValue && !strcmp(pcValue, "0"))
+    {
+        g_bHostPacing = false;
+    }
+
+    pcValue = getenv("HOST_LINGER_MS");
+    if(pcValue)
+    {
+        g_ui64HostLingerNs = strtoull(pcValue, 0, 0) * 1000000ull;
+    }
+}
+
+//*****************************************************************************
+//
+// UART API.
+//
+//*****************************************************************************
+void
+UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                    uint32_t ui32Baud, uint32_t ui32Config)
+{
+    tHostUART *psUART;
+    pthread_t sThread;
+    bool bStart;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+
+    bStart = !psUART->bOpen;
+    if(bStart)
+    {
+        HostUARTOpen(psUART);
+    }
+
+    psUART->ui32Divisor = (((ui32UARTClk * 8) / ui32Baud) + 1) / 2;
+    psUART->bEnabled = true;
+    if(!psUART->bConsole && (psUART->iTxFd >= 0) && isatty(psUART->iTxFd))
+    {
+        HostTermSpeed(psUART->iTxFd, ui32Baud);
+    }
+    HostUARTService(psUART);
+
+    HostUnlock();
+
+    if(bStart)
+    {
+        if(psUART->iRxFd >= 0)
+        {
+            pthread_create(&sThread, 0, HostUARTRxThread, psUART);
+        }
+        pthread_create(&sThread, 0, HostUARTTxThread, psUART);
+    }
+}
+
+void
+UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+    HostLock();
+    HostUARTGet(ui32Base)->bPIOSC = (ui32Source == UART_CLOCK_PIOSC);
+    HostUnlock();
+}
+
+void
+UARTEnable(uint32_t ui32Base)
+{
+    HostLock();
+    HostUARTGet(ui32Base)->bEnabled = true;
+    HostSignal();
+    HostUnlock();
+}
+
+void
+UARTDisable(uint32_t ui32Base)
+{
+    HostLock();
+    HostUARTGet(ui32Base)->bEnabled = false;
+    HostUnlock();
+}
+
+void
+UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                 uint32_t ui32RxLevel)
+{
+    tHostUART *psUART;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+    psUART->ui32FIFOLevel = ui32TxLevel | ui32RxLevel;
+    HostUARTService(psUART);
+    HostUnlock();
+}
+
+void
+UARTFlowControlSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+    HostLock();
+    HostUARTGet(ui32Base)->ui32FlowControl = ui32Mode;
+    HostSignal();
+    HostUnlock();
+}
+
+bool
+UARTCharsAvail(uint32_t ui32Base)
+{
+    bool bAvail;
+
+    HostLock();
+    bAvail = HostUARTGet(ui32Base)->ui32RxCount != 0;
+    HostUnlock();
+
+    //
+    // Callers poll this in a loop; give the other threads a turn.
+    //
+    if(!bAvail)
+    {
+        sched_yield();
+    }
+
+    return(bAvail);
+}
+
+bool
+UARTSpaceAvail(uint32_t ui32Base)
+{
+    bool bSpace;
+
+    HostLock();
+    bSpace = HostUARTGet(ui32Base)->ui32TxCount != UART_FIFO_SIZE;
+    HostUnlock();
+
+    return(bSpace);
+}
+
+int32_t
+UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    tHostUART *psUART;
+    int32_t i32Data;
+
+    psUART = HostUARTGet(ui32Base);
+    i32Data = -1;
+
+    HostLock();
+    if(psUART->ui32RxCount)
+    {
+        i32Data = psUART->pui8RxFIFO[psUART->ui32RxRead];
+        psUART->ui32RxRead = (psUART->ui32RxRead + 1) % UART_FIFO_SIZE;
+        psUART->ui32RxCount--;
+        HostUARTService(psUART);
+    }
+    HostUnlock();
+
+    return(i32Data);
+}
+
+int32_t
+UARTCharGet(uint32_t ui32Base)
+{
+    tHostUART *psUART;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+    while(!psUART->ui32RxCount)
+    {
+        HostWait(0);
+    }
+    HostUnlock();
+
+    return(UARTCharGetNonBlocking(ui32Base));
+}
+
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    tHostUART *psUART;
+    bool bPut;
+
+    psUART = HostUARTGet(ui32Base);
+    bPut = false;
+
+    HostLock();
+    if(psUART->ui32TxCount != UART_FIFO_SIZE)
+    {
+        psUART->pui8TxFIFO[(psUART->ui32TxRead + psUART->ui32TxCount) %
+                           UART_FIFO_SIZE] = ucData;
+        psUART->ui32TxCount++;
+        HostUARTService(psUART);
+        bPut = true;
+    }
+    HostUnlock();
+
+    return(bPut);
+}
+
+void
+UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    tHostUART *psUART;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+    while(psUART->ui32TxCount == UART_FIFO_SIZE)
+    {
+        HostWait(0);
+    }
+    UARTCharPutNonBlocking(ui32Base, ucData);
+    HostUnlock();
+}
+
+bool
+UARTBusy(uint32_t ui32Base)
+{
+    bool bBusy;
+
+    HostLock();
+    bBusy = HostUARTGet(ui32Base)->ui32TxCount != 0;
+    HostUnlock();
+
+    return(bBusy);
+}
+
+void
+UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    tHostUART *psUART;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+    psUART->ui32IM |= ui32IntFlags;
+    HostUARTService(psUART);
+    HostUnlock();
+}
+
+void
+UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    HostLock();
+    HostUARTGet(ui32Base)->ui32IM &= ~ui32IntFlags;
+    HostUnlock();
+}
+
+uint32_t
+UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    tHostUART *psUART;
+    uint32_t ui32Status;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+    ui32Status = psUART->ui32RIS;
+    if(bMasked)
+    {
+        ui32Status &= psUART->ui32IM;
+    }
+    HostUnlock();
+
+    return(ui32Status);
+}
+
+void
+UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    tHostUART *psUART;
+
+    psUART = HostUARTGet(ui32Base);
+
+    //
+    // The FIFO level flags are recomputed straight away, so clearing them
+    // only lasts while the condition is gone, like the level sensitive
+    // behaviour the drivers rely on.
+    //
+    HostLock();
+    psUART->ui32RIS &= ~ui32IntFlags;
+    if(ui32IntFlags & (UART_INT_RX | UART_INT_TX))
+    {
+        psUART->ui32RIS &= ~(UART_INT_RX | UART_INT_TX);
+    }
+    HostUnlock();
+}
+
+void
+UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    tHostUART *psUART;
+
+    psUART = HostUARTGet(ui32Base);
+
+    HostLock();
+    psUART->ui32DMAControl |= ui32DMAFlags;
+    HostUARTService(psUART);
+    HostUnlock();
+}
+
+void
+UARTDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    HostLock();
+    HostUARTGet(ui32Base)->ui32DMAControl &= ~ui32DMAFlags;
+    HostUnlock();
+}
+
+void
+UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+}
+
+//*****************************************************************************
+//
+// uDMA API.
+//
+//*****************************************************************************
+static void
+HostDMAServiceAll(void)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_HOST_UARTS; ui32Index++)
+    {
+        if(g_psHostUART[ui32Index].bOpen)
+        {
+            HostUARTService(&g_psHostUART[ui32Index]);
+        }
+    }
+}
+
+void
+uDMAEnable(void)
+{
+    HostLock();
+    g_bHostDMAEnabled = true;
+    HostDMAServiceAll();
+    HostUnlock();
+}
+
+void
+uDMADisable(void)
+{
+    HostLock();
+    g_bHostDMAEnabled = false;
+    HostUnlock();
+}
+
+uint32_t
+uDMAErrorStatusGet(void)
+{
+    return(0);
+}
+
+void
+uDMAErrorStatusClear(void)
+{
+}
+
+void
+uDMAControlBaseSet(void *pControlTable)
+{
+}
+
+void
+uDMAChannelAssign(uint32_t ui32Mapping)
+{
+    HostLock();
+    g_psHostDMA[ui32Mapping & 0x1f].ui32Assign = ui32Mapping >> 16;
+    HostUnlock();
+}
+
+void
+uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+    HostLock();
+    g_psHostDMA[ui32ChannelNum & 0x1f].bEnabled = true;
+    HostDMAServiceAll();
+    HostUnlock();
+}
+
+void
+uDMAChannelDisable(uint32_t ui32ChannelNum)
+{
+    HostLock();
+    g_psHostDMA[ui32ChannelNum & 0x1f].bEnabled = false;
+    HostUnlock();
+}
+
+bool
+uDMAChannelIsEnabled(uint32_t ui32ChannelNum)
+{
+    bool bEnabled;
+
+    HostLock();
+    bEnabled = g_psHostDMA[ui32ChannelNum & 0x1f].bEnabled;
+    HostUnlock();
+
+    return(bEnabled);
+}
+
+void
+uDMAChannelAttributeEnable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    HostLock();
+    g_psHostDMA[ui32ChannelNum & 0x1f].ui32Attr |= ui32Attr;
+    HostDMAServiceAll();
+    HostUnlock();
+}
+
+void
+uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    HostLock();
+    g_psHostDMA[ui32ChannelNum & 0x1f].ui32Attr &= ~ui32Attr;
+    HostDMAServiceAll();
+    HostUnlock();
+}
+
+uint32_t
+uDMAChannelAttributeGet(uint32_t ui32ChannelNum)
+{
+    return(g_psHostDMA[ui32ChannelNum & 0x1f].ui32Attr);
+}
+
+void
+uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+    HostLock();
+    g_psHostDMA[ui32ChannelStructIndex & 0x1f].psControl[
+        (ui32ChannelStructIndex & UDMA_ALT_SELECT) ? 1 : 0].ui32Control =
+        ui32Control;
+    HostUnlock();
+}
+
+void
+uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                       void *pvSrcAddr, void *pvDstAddr,
+                       uint32_t ui32TransferSize)
+{
+    tHostDMAControl *psControl;
+
+    HostLock();
+    psControl = &g_psHostDMA[ui32ChannelStructIndex & 0x1f].psControl[
+        (ui32ChannelStructIndex & UDMA_ALT_SELECT) ? 1 : 0];
+    psControl->ui32Mode = ui32Mode;
+    psControl->pui8Src = pvSrcAddr;
+    psControl->pui8Dst = pvDstAddr;
+    psControl->ui32Size = ui32TransferSize;
+    psControl->ui32Remaining = ui32TransferSize;
+    HostUnlock();
+}
+
+uint32_t
+uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex)
+{
+    tHostDMAControl *psControl;
+    uint32_t ui32Size;
+
+    HostLock();
+    psControl = &g_psHostDMA[ui32ChannelStructIndex & 0x1f].psControl[
+        (ui32ChannelStructIndex & UDMA_ALT_SELECT) ? 1 : 0];
+    ui32Size = (psControl->ui32Mode == UDMA_MODE_STOP) ?
+               0 : psControl->ui32Remaining;
+    HostUnlock();
+
+    return(ui32Size);
+}
+
+uint32_t
+uDMAChannelModeGet(uint32_t ui32ChannelStructIndex)
+{
+    uint32_t ui32Mode;
+
+    HostLock();
+    ui32Mode = g_psHostDMA[ui32ChannelStructIndex & 0x1f].psControl[
+        (ui32ChannelStructIndex & UDMA_ALT_SELECT) ? 1 : 0].ui32Mode;
+    HostUnlock();
+
+    return(ui32Mode);
+}
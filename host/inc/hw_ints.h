@@ -0,0 +1,38 @@
+//*****************************************************************************
+//
+// hw_ints.h - Host build copy of the TM4C123 interrupt assignments.
+//
+//*****************************************************************************
+
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+#define FAULT_SYSTICK           15
+#define INT_GPIOA               16
+#define INT_GPIOB               17
+#define INT_GPIOC               18
+#define INT_GPIOD               19
+#define INT_GPIOE               20
+#define INT_UART0               21
+#define INT_UART1               22
+#define INT_TIMER0A             35
+#define INT_TIMER0B             36
+#define INT_TIMER1A             37
+#define INT_TIMER1B             38
+#define INT_TIMER2A             39
+#define INT_TIMER2B             40
+#define INT_GPIOF               46
+#define INT_UART2               49
+#define INT_UDMA                62
+#define INT_UDMAERR             63
+#define INT_UART3               75
+#define INT_UART4               76
+#define INT_UART5               77
+#define INT_UART6               78
+#define INT_UART7               79
+#define INT_WTIMER5A            120
+#define INT_WTIMER5B            121
+
+#define NUM_INTERRUPTS          155
+
+#endif // __HW_INTS_H__
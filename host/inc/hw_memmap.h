@@ -0,0 +1,42 @@
+//*****************************************************************************
+//
+// hw_memmap.h - Host build copy of the TM4C123 peripheral base addresses.
+//
+// The values match the device so that addresses derived from them, such as
+// the UART data register handed to the uDMA controller, can be decoded by
+// the shim.
+//
+//*****************************************************************************
+
+#ifndef __HW_MEMMAP_H__
+#define __HW_MEMMAP_H__
+
+#define WATCHDOG0_BASE          0x40000000
+#define GPIO_PORTA_BASE         0x40004000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTC_BASE         0x40006000
+#define GPIO_PORTD_BASE         0x40007000
+#define UART0_BASE              0x4000C000
+#define UART1_BASE              0x4000D000
+#define UART2_BASE              0x4000E000
+#define UART3_BASE              0x4000F000
+#define UART4_BASE              0x40010000
+#define UART5_BASE              0x40011000
+#define UART6_BASE              0x40012000
+#define UART7_BASE              0x40013000
+#define GPIO_PORTE_BASE         0x40024000
+#define GPIO_PORTF_BASE         0x40025000
+#define TIMER0_BASE             0x40030000
+#define TIMER1_BASE             0x40031000
+#define TIMER2_BASE             0x40032000
+#define TIMER3_BASE             0x40033000
+#define TIMER4_BASE             0x40034000
+#define TIMER5_BASE             0x40035000
+#define WTIMER0_BASE            0x40036000
+#define WTIMER1_BASE            0x40037000
+#define WTIMER5_BASE            0x4004F000
+#define EEPROM_BASE             0x400AF000
+#define SYSCTL_BASE             0x400FE000
+#define UDMA_BASE               0x400FF000
+
+#endif // __HW_MEMMAP_H__
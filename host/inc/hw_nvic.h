@@ -0,0 +1,14 @@
+//*****************************************************************************
+//
+// hw_nvic.h - Host build copy of the NVIC and SysTick register addresses.
+//
+//*****************************************************************************
+
+#ifndef __HW_NVIC_H__
+#define __HW_NVIC_H__
+
+#define NVIC_ST_CTRL            0xE000E010
+#define NVIC_ST_RELOAD          0xE000E014
+#define NVIC_ST_CURRENT         0xE000E018
+
+#endif // __HW_NVIC_H__
@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// hw_timer.h - Host build copy of the general purpose timer register offsets.
+//
+//*****************************************************************************
+
+#ifndef __HW_TIMER_H__
+#define __HW_TIMER_H__
+
+#define TIMER_O_CFG             0x00000000
+#define TIMER_O_TAMR            0x00000004
+#define TIMER_O_TBMR            0x00000008
+#define TIMER_O_CTL             0x0000000C
+#define TIMER_O_TAILR           0x00000028
+#define TIMER_O_TBILR           0x0000002C
+
+#endif // __HW_TIMER_H__
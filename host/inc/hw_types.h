@@ -0,0 +1,24 @@
+//*****************************************************************************
+//
+// hw_types.h - Host build replacement for the TivaWare register access macros.
+//
+// On the host there is no peripheral address space, so every register access
+// through HWREG() is redirected to a sparse register file kept by the shim.
+// Code that pokes registers directly (buttons.c, rgb.c) keeps working, but
+// the values written have no effect beyond being read back.
+//
+//*****************************************************************************
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern volatile uint32_t *HostRegister(uint32_t ui32Address);
+
+#define HWREG(x)                (*HostRegister((uint32_t)(x)))
+#define HWREGH(x)               (*(volatile uint16_t *)HostRegister((uint32_t)(x)))
+#define HWREGB(x)               (*(volatile uint8_t *)HostRegister((uint32_t)(x)))
+
+#endif // __HW_TYPES_H__
@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// hw_uart.h - Host build copy of the UART register offsets.
+//
+//*****************************************************************************
+
+#ifndef __HW_UART_H__
+#define __HW_UART_H__
+
+#define UART_O_DR               0x00000000
+#define UART_O_FR               0x00000018
+#define UART_O_IBRD             0x00000024
+#define UART_O_FBRD             0x00000028
+#define UART_O_LCRH             0x0000002C
+#define UART_O_CTL              0x00000030
+
+#endif // __HW_UART_H__
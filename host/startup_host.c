@@ -0,0 +1,45 @@
+//*****************************************************************************
+//
+// startup_host.c - Interrupt vector table for the host build.
+//
+// Mirrors the handlers wired in tm4c123gh6pm_startup_ccs.c.  Keep the two in
+// step when a handler is added there.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "host.h"
+
+//*****************************************************************************
+//
+// External declarations for the interrupt handlers used by the application.
+//
+//*****************************************************************************
+extern void ModemIntHandler(void);
+extern void UART0IntHandler(void);
+extern void uDMAErrorHandler(void);
+extern void Button0IntHandler(void);
+extern void CoalesceTimerIntHandler(void);
+extern void GuardTimerIntHandler(void);
+extern void SysTickIntHandler(void);
+
+//*****************************************************************************
+//
+// The vector table, indexed by interrupt number.
+//
+//*****************************************************************************
+void (* const g_pfnHostVectors[NUM_INTERRUPTS])(void) =
+{
+    [FAULT_SYSTICK] = SysTickIntHandler,
+    [INT_UART0] = UART0IntHandler,
+    [INT_TIMER2A] = CoalesceTimerIntHandler,
+    [INT_GPIOF] = Button0IntHandler,
+    [INT_UDMAERR] = uDMAErrorHandler,
+#ifdef MODEM_UART1
+    [INT_UART1] = ModemIntHandler,
+#else
+    [INT_UART5] = ModemIntHandler,
+#endif
+    [INT_WTIMER5A] = GuardTimerIntHandler,
+};
@@ -39,6 +39,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "inc/hw_memmap.h"
 #include "inc/hw_ints.h"
@@ -51,8 +53,25 @@
 #include "driverlib/rom.h"
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
 #include "driverlib/uart.h"
+#include "driverlib/udma.h"
 #include "drivers/buttons.h"
+#include "drivers/at_parser.h"
+#include "drivers/at_queue.h"
+#include "drivers/clock.h"
+#include "drivers/coalesce.h"
+#include "drivers/event_queue.h"
+#include "drivers/governor.h"
+#include "drivers/histogram.h"
+#include "drivers/profile.h"
+#include "drivers/ringbuf.h"
+#include "drivers/link_mux.h"
+#include "drivers/rgb.h"
+#include "drivers/scan_list.h"
+#include "drivers/settings.h"
+#include "drivers/uart_dma.h"
 
 //*****************************************************************************
 //
@@ -95,149 +114,2382 @@ __error__(char *pcFilename, uint32_t ui32Line)
 }
 #endif
 
-char ssid_list[32][32];
 //*****************************************************************************
 //
-// Insert into list with SSID's
+// The events the interrupt handlers post to the main loop.  A handler only
+// moves data into a ring or sets a flag, then posts one of these; the main
+// loop does the rest and sleeps when there is nothing left to do.
 //
 //*****************************************************************************
-void put(char* name, int index)
+#define EVENT_MODEM             1
+#define EVENT_CONSOLE           2
+#define EVENT_BUTTON            3
+#define EVENT_COALESCE          4
+#define EVENT_GUARD             5
+#define EVENT_TIMEOUT           6
+#define EVENT_CLOCK             7
+
+tEventQueue g_sEvents;
+
+//*****************************************************************************
+//
+// One shot timers counting in system clock cycles.  The time each is due is
+// also kept on the monotonic clock, so that a change of system clock can
+// reload it with the time left at the new rate.  bArmed is cleared by the
+// timer's interrupt handler.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Base;
+    volatile bool bArmed;
+    uint32_t ui32Due;
+}
+tOneShot;
+
+tOneShot g_sCoalesceTimer = { TIMER2_BASE, false, 0 };
+tOneShot g_sGuardTimer = { WTIMER5_BASE, false, 0 };
+
+void
+OneShotStart(tOneShot *psTimer, uint32_t ui32Ms)
+{
+    TimerDisable(psTimer->ui32Base, TIMER_A);
+    psTimer->ui32Due = ClockUs() + (ui32Ms * 1000);
+    psTimer->bArmed = true;
+    TimerLoadSet(psTimer->ui32Base, TIMER_A, (SysCtlClockGet() / 1000) * ui32Ms);
+    TimerEnable(psTimer->ui32Base, TIMER_A);
+}
+
+void
+OneShotStop(tOneShot *psTimer)
+{
+    TimerDisable(psTimer->ui32Base, TIMER_A);
+    psTimer->bArmed = false;
+}
+
+//
+// Called with interrupts masked.  A timer whose interrupt is already
+// pending is left to it.
+//
+void
+OneShotRescale(tOneShot *psTimer)
+{
+    int32_t i32Left;
+
+    if(!psTimer->bArmed ||
+       (TimerIntStatus(psTimer->ui32Base, false) & TIMER_TIMA_TIMEOUT)) {
+        return;
+    }
+
+    i32Left = (int32_t)(psTimer->ui32Due - ClockUs());
+    if(i32Left < 1) {
+        i32Left = 1;
+    }
+
+    TimerDisable(psTimer->ui32Base, TIMER_A);
+    TimerLoadSet(psTimer->ui32Base, TIMER_A, (SysCtlClockGet() / 1000000) * i32Left);
+    TimerEnable(psTimer->ui32Base, TIMER_A);
+}
+
+//*****************************************************************************
+//
+// Cycle count profiles of the interrupt handlers and of the main loop's
+// busiest calls, shown by menu choice 8.
+//
+//*****************************************************************************
+tProfile g_sModemProfile = PROFILE_INIT("ModemIntHandler");
+tProfile g_sUART0Profile = PROFILE_INIT("UART0IntHandler");
+tProfile g_sSysTickProfile = PROFILE_INIT("SysTickIntHandler");
+tProfile g_sButton0Profile = PROFILE_INIT("Button0IntHandler");
+tProfile g_sCoalesceTimerProfile = PROFILE_INIT("CoalesceTimerIntHandler");
+tProfile g_sGuardTimerProfile = PROFILE_INIT("GuardTimerIntHandler");
+tProfile g_sModemPollProfile = PROFILE_INIT("ModemPoll");
+tProfile g_sConsoleProfile = PROFILE_INIT("ConsoleService");
+
+//*****************************************************************************
+//
+// Rings between the UART interrupt handlers and the main loop.  Bytes
+// received from the ESP8266 are moved in blocks by the uDMA channel and only
+// queued by the interrupt handler; all parsing happens in ModemPoll().
+// Console input is queued by the UART0 interrupt handler.  Output to either
+// UART is queued by UARTSend() and moved to the UART by its uDMA channel.
+//
+// The console has no flow control, and input waits in its ring while a
+// passthrough line is handed to the module.  CONSOLE_RX_SIZE holds about
+// 180 ms of typing at 115200 baud, which covers an AT+CIPSEND round trip
+// with the queue full of lines behind it.  What still does not fit is
+// counted in the ring's ui32Dropped, and FIFO overruns in
+// g_ui32ConsoleOverruns; "++stats" shows both.
+//
+//*****************************************************************************
+#define CONSOLE_RX_SIZE         2048
+
+uint8_t g_pui8ModemRxBuf[1024];
+uint8_t g_pui8ModemTxBuf[256];
+uint8_t g_pui8UART0RxBuf[CONSOLE_RX_SIZE];
+uint8_t g_pui8UART0TxBuf[512];
+tRingBuf g_sModemRxRing;
+tRingBuf g_sModemTxRing;
+tRingBuf g_sUART0RxRing;
+tRingBuf g_sUART0TxRing;
+volatile uint32_t g_ui32ConsoleOverruns;
+
+//*****************************************************************************
+//
+// The UART the ESP8266 is on.  The LaunchPad wires it to UART5 on PE4 and
+// PE5, which has no flow control lines.  Building with MODEM_UART1 defined
+// moves it to UART1 on PB0 and PB1, with RTS on PC4 and CTS on PC5, and
+// MODEM_FLOW, the flow control field of AT+UART_CUR, has the module use
+// them as well: our RTS holds the module off while the receive FIFO is
+// full, and its RTS holds our transmitter off while it is busy.
+//
+//*****************************************************************************
+#ifdef MODEM_UART1
+#define MODEM_UART_BASE         UART1_BASE
+#define MODEM_UART_PERIPH       SYSCTL_PERIPH_UART1
+#define MODEM_FLOW              3
+#else
+#define MODEM_UART_BASE         UART5_BASE
+#define MODEM_UART_PERIPH       SYSCTL_PERIPH_UART5
+#define MODEM_FLOW              0
+#endif
+
+//*****************************************************************************
+//
+// The ESP8266 UART interrupt handler.  The module talks at MODEM_BAUD after
+// a reset and at g_ui32ModemBaud once the rate has been negotiated.  Receive
+// errors are counted in g_ui32ModemErrors, and overruns, which lose bytes,
+// in g_ui32ModemOverruns as well.  The console runs at CONSOLE_BAUD.
+//
+//*****************************************************************************
+#define MODEM_BAUD              115200
+#ifndef CONSOLE_BAUD
+#define CONSOLE_BAUD            115200
+#endif
+
+uint32_t g_ui32ModemBaud = MODEM_BAUD;
+volatile uint32_t g_ui32ModemErrors;
+volatile uint32_t g_ui32ModemOverruns;
+
+void
+ModemIntHandler(void)
+{
+    uint32_t ui32Status;
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
+
+    //
+    // Get the interrupt status.
+    //
+    ui32Status = UARTIntStatus(MODEM_UART_BASE, true);
+
+    //
+    // Clear the asserted interrupts.
+    //
+    UARTIntClear(MODEM_UART_BASE, ui32Status);
+
+    if(ui32Status & (UART_INT_OE | UART_INT_BE | UART_INT_FE))
+    {
+        g_ui32ModemErrors++;
+    }
+    if(ui32Status & UART_INT_OE)
+    {
+        g_ui32ModemOverruns++;
+    }
+
+    UARTDMARxIntHandler(MODEM_UART_BASE, ui32Status);
+    UARTDMATxIntHandler(MODEM_UART_BASE);
+
+    if(RingBufUsed(&g_sModemRxRing))
+    {
+        EventPost(&g_sEvents, EVENT_MODEM);
+    }
+
+    PROFILE_END(&g_sModemProfile, ui32Start);
+}
+
+//*****************************************************************************
+//
+// The UART0 interrupt handler.
+//
+//*****************************************************************************
+void
+UART0IntHandler(void)
+{
+    uint32_t ui32Status;
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
+
+    ui32Status = UARTIntStatus(UART0_BASE, true);
+    UARTIntClear(UART0_BASE, ui32Status);
+
+    if(ui32Status & UART_INT_OE)
+    {
+        g_ui32ConsoleOverruns++;
+    }
+
+    //
+    // Typed characters are moved to the console ring; anything that does not
+    // fit is dropped and counted, as the FIFO would have done.
+    //
+    while(UARTCharsAvail(UART0_BASE))
+    {
+        RingBufPut(&g_sUART0RxRing, UARTCharGetNonBlocking(UART0_BASE));
+    }
+
+    if(RingBufUsed(&g_sUART0RxRing))
+    {
+        EventPost(&g_sEvents, EVENT_CONSOLE);
+    }
+
+    UARTDMATxIntHandler(UART0_BASE);
+
+    PROFILE_END(&g_sUART0Profile, ui32Start);
+}
+
+//*****************************************************************************
+//
+// Clock profiles.  The governor runs at CLOCK_HIGH while there is work and
+// drops to CLOCK_LOW after CLOCK_IDLE_MS without any event; "++clock" fixes
+// one profile instead.  The UARTs are clocked from the 16 MHz PIOSC, so
+// their baud rates do not move when the system clock does and a byte
+// arriving during a switch is not lost.  SysTick and the one shot timers
+// count system clock cycles and are reloaded by ClockApply() on every
+// switch.
+//
+//*****************************************************************************
+#define SYSTICK_HZ              100
+#define UART_CLOCK_HZ           16000000
+#define CLOCK_IDLE_MS           250
+#define CLOCK_LOW               0
+#define CLOCK_HIGH              2
+
+const tClockProfile g_psClockProfiles[] =
+{
+    { "16", SYSCTL_SYSDIV_1 | SYSCTL_USE_OSC | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ },
+    { "40", SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ },
+    { "80", SYSCTL_SYSDIV_2_5 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN | SYSCTL_XTAL_16MHZ },
+};
+
+#define NUM_CLOCK_PROFILES      (sizeof(g_psClockProfiles) / sizeof(g_psClockProfiles[0]))
+
+tGovernor g_sGovernor;
+
+void
+ClockApply(uint32_t ui32OldHz, uint32_t ui32NewHz)
+{
+    ClockInit(ui32NewHz, SYSTICK_HZ);
+    OneShotRescale(&g_sCoalesceTimer);
+    OneShotRescale(&g_sGuardTimer);
+}
+
+//*****************************************************************************
+//
+// The SysTick interrupt handler, SYSTICK_HZ times a second.  The uDMA channel
+// hands ESP8266 data over when a block fills or the receive timeout fires,
+// and the timeout does not fire when a burst leaves the FIFO exactly empty.
+// The partly filled block is collected here instead, from interrupt context
+// so that the ring keeps a single writer.  A payload the console could not
+// take yet is also offered again on each tick.
+//
+// The ticks also keep the monotonic clock, and the handler posts
+// EVENT_TIMEOUT once the AT command queue's deadline, g_ui32ModemDeadline,
+// has passed, and EVENT_CLOCK once the governor is due to lower the clock.
+//
+//*****************************************************************************
+volatile bool g_bModemDeadline = false;
+volatile uint32_t g_ui32ModemDeadline;
+
+void
+SysTickIntHandler(void)
+{
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
+
+    ClockTick();
+
+    UARTDMARxPoll(MODEM_UART_BASE);
+
+    if(RingBufUsed(&g_sModemRxRing))
+    {
+        EventPost(&g_sEvents, EVENT_MODEM);
+    }
+
+    if(g_bModemDeadline &&
+       ((int32_t)(ClockUs() - g_ui32ModemDeadline) >= 0))
+    {
+        g_bModemDeadline = false;
+        EventPost(&g_sEvents, EVENT_TIMEOUT);
+    }
+
+    if(GovernorIdleDue(&g_sGovernor))
+    {
+        EventPost(&g_sEvents, EVENT_CLOCK);
+    }
+
+    PROFILE_END(&g_sSysTickProfile, ui32Start);
+}
+
+//*****************************************************************************
+//
+// Send a string to the UART.  This function queues a string of characters for
+// a particular UART module, waiting only while the transmit ring is full.
+//
+//*****************************************************************************
+void
+UARTSend(uint32_t ui32UARTBase, const uint8_t *pui8Buffer, uint32_t ui32Count)
+{
+    uint32_t ui32Written;
+
+    while(ui32Count)
+    {
+        ui32Written = UARTDMAWrite(ui32UARTBase, pui8Buffer, ui32Count);
+        pui8Buffer += ui32Written;
+        ui32Count -= ui32Written;
+    }
+}
+
+//*****************************************************************************
+//
+// Write a single character to the console.
+//
+//*****************************************************************************
+void
+ConsolePutChar(char cChar)
+{
+    UARTSend(UART0_BASE, (uint8_t *)&cChar, 1);
+}
+
+//*****************************************************************************
+//
+// Parse whatever the ESP8266 has sent since the last call.  This runs in
+// thread context, from the main loop after every event.
+//
+//*****************************************************************************
+tATParser g_sATParser;
+
+int listing_networks = 0;
+
+//*****************************************************************************
+//
+// The access points of the last scan.  Each +CWLAP line is captured in
+// g_pcScanLine and parsed into g_sScanList as soon as it ends.
+//
+//*****************************************************************************
+tScanList g_sScanList;
+char g_pcScanLine[SCAN_LIST_LINE_SIZE];
+
+//*****************************************************************************
+//
+// A scan takes seconds, so its results are shown again without scanning
+// for SCAN_TTL_MS after it finished.  Before the first scan after the module
+// starts, AT+CWLAPOPT asks it to sort by RSSI and send only the fields of
+// SCAN_FIELDS: encryption, SSID, RSSI, BSSID and channel.  A module that
+// does not know the command sends whole lines, which parse just the same.
+//
+//*****************************************************************************
+#ifndef SCAN_TTL_MS
+#define SCAN_TTL_MS             30000
+#endif
+#define SCAN_FIELDS             "31"
+
+bool g_bScanValid = false;
+uint32_t g_ui32ScanTime;
+bool g_bScanOptions = false;
+
+//*****************************************************************************
+//
+// Commands to the ESP8266 go through g_sATQueue.  ModemCommand() and
+// ModemLinkSend() queue one and return; the queue sends each as soon as the
+// one before has finished and calls the completion function passed in, from
+// ModemPoll(), with the result.  A completion function may queue more.
+//
+//*****************************************************************************
+tATQueue g_sATQueue;
+
+void
+ModemWrite(const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    UARTSend(MODEM_UART_BASE, pui8Data, ui32Count);
+}
+
+//*****************************************************************************
+//
+// Received TCP data.  The payload of each +IPD frame is handed to
+// g_pfnPayloadHandler straight out of the modem receive ring, in as few calls
+// as the ring layout allows.  The handler returns how many bytes it took;
+// taking fewer leaves the rest in the ring until the next ModemPoll().
+//
+// PayloadToConsole(), the default, prints the data.  PayloadToRing() queues
+// it in g_psPayloadRing for code that wants to read it back.  With multiple
+// connections PayloadToLink() sorts it into the receive buffer of its link.
+//
+//*****************************************************************************
+typedef uint32_t (*tPayloadHandler)(uint32_t ui32Link, const uint8_t *pui8Data,
+                                    uint32_t ui32Count);
+
+uint32_t
+PayloadToConsole(uint32_t ui32Link, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    return(UARTDMAWrite(UART0_BASE, pui8Data, ui32Count));
+}
+
+tRingBuf *g_psPayloadRing;
+
+uint32_t
+PayloadToRing(uint32_t ui32Link, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    return(RingBufWrite(g_psPayloadRing, pui8Data, ui32Count));
+}
+
+//*****************************************************************************
+//
+// Multiple connections (AT+CIPMUX=1).  Each of the module's link IDs gets a
+// send queue and a receive buffer in g_sLinks.  Passthrough messages are
+// queued for the selected link, g_ui32Link, and LinksService() sends from the
+// queues in turn, at most LINK_QUANTUM bytes per AT+CIPSEND, so every open
+// link gets its share of the module.
+//
+//*****************************************************************************
+#define LINK_BUF_SIZE           512
+#define LINK_QUANTUM            256
+
+uint8_t g_pui8LinkTxBuf[LINK_MUX_LINKS * LINK_BUF_SIZE];
+uint8_t g_pui8LinkRxBuf[LINK_MUX_LINKS * LINK_BUF_SIZE];
+tLinkMux g_sLinks;
+bool g_bMux = false;
+uint32_t g_ui32Link = 0;
+
+uint32_t
+PayloadToLink(uint32_t ui32Link, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    return(LinkMuxReceive(&g_sLinks, ui32Link, pui8Data, ui32Count));
+}
+
+tPayloadHandler g_pfnPayloadHandler = PayloadToConsole;
+
+//*****************************************************************************
+//
+// In transparent transmission everything the module sends is data, and
+// ModemPoll() copies it to the console without parsing it.
+//
+//*****************************************************************************
+bool g_bModemRaw = false;
+
+void
+ModemPoll(void)
+{
+    uint8_t k;
+    uint8_t *pui8Data;
+    uint32_t ui32Count;
+    uint32_t ui32Left;
+    uint32_t ui32Event;
+
+    while(1)
+    {
+        if(g_bModemRaw)
+        {
+            ui32Count = RingBufReadSpan(&g_sModemRxRing, &pui8Data);
+            if(ui32Count)
+            {
+                ui32Count = UARTDMAWrite(UART0_BASE, pui8Data, ui32Count);
+            }
+
+            if(ui32Count == 0) {
+                break;
+            }
+
+            RingBufAdvance(&g_sModemRxRing, ui32Count);
+            continue;
+        }
+
+        //
+        // Payload bytes bypass the parser's token matching altogether.
+        //
+        ui32Left = ATParserPayloadLeft(&g_sATParser);
+        if(ui32Left)
+        {
+            ui32Count = RingBufReadSpan(&g_sModemRxRing, &pui8Data);
+            if(ui32Count > ui32Left)
+            {
+                ui32Count = ui32Left;
+            }
+
+            if(ui32Count)
+            {
+                ui32Count = g_pfnPayloadHandler(ATParserLink(&g_sATParser),
+                                                pui8Data, ui32Count);
+            }
+
+            if(ui32Count == 0) {
+                break;
+            }
+
+            RingBufAdvance(&g_sModemRxRing, ui32Count);
+            ATParserPayloadSkip(&g_sATParser, ui32Count);
+            continue;
+        }
+
+        if(!RingBufGet(&g_sModemRxRing, &k)) {
+            break;
+        }
+
+        ui32Event = ATParserFeed(&g_sATParser, k);
+
+        //
+        // Echo everything except the scan results and the SSID/password part
+        // of an AT+CWJAP= command.
+        //
+        if(listing_networks == 0 &&
+           ATParserLineKind(&g_sATParser) != AT_EVENT_ECHO_CWJAP &&
+           ui32Event != AT_EVENT_ECHO_CWJAP) {
+            ConsolePutChar(k);
+        }
+
+        switch(ui32Event)
+        {
+        case AT_EVENT_ECHO_CWLAP:
+            listing_networks = 1;
+            ScanListClear(&g_sScanList);
+            ATParserLineBufferSet(&g_sATParser, g_pcScanLine, sizeof(g_pcScanLine));
+            UARTSend(UART0_BASE, (uint8_t *)"\r\n", 2);
+            break;
+        case AT_EVENT_SCAN_ENTRY:
+            if(listing_networks == 1) {
+                ScanListAdd(&g_sScanList, g_pcScanLine);
+            }
+            break;
+        case AT_EVENT_CONNECT:
+            LinkMuxOpened(&g_sLinks, g_bMux ? ATParserLink(&g_sATParser) : 0);
+            break;
+        case AT_EVENT_CLOSED:
+            LinkMuxClosed(&g_sLinks, g_bMux ? ATParserLink(&g_sATParser) : 0);
+            break;
+        case AT_EVENT_OK:
+        case AT_EVENT_SEND_OK:
+        case AT_EVENT_ERROR:
+        case AT_EVENT_FAIL:
+        case AT_EVENT_SEND_FAIL:
+            listing_networks = 0;
+            ATParserLineBufferSet(&g_sATParser, 0, 0);
+            break;
+        default:
+            break;
+        }
+
+        if(ui32Event != AT_EVENT_NONE) {
+            ATQueueEvent(&g_sATQueue, ui32Event);
+        }
+    }
+
+    //
+    // The receive channel stops when the ring runs short of room; now that
+    // some has been read, let it go on.
+    //
+    UARTDMARxRelease(MODEM_UART_BASE);
+}
+
+//*****************************************************************************
+//
+// Timeout and retry policies, by command.  A scan takes a few seconds and a
+// join up to fifteen; a join or a connection is not repeated, since a second
+// attempt only finds the module still busy with the first.  A send should be
+// answered within milliseconds, and is only repeated while its data has not
+// gone out.  A change of link rate is not repeated either, as the module
+// may have switched already.  Anything else gets the queue's default of a
+// second and two retries; AT+CWLAPOPT is listed only to keep it from
+// matching AT+CWLAP.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcPrefix;
+    tATPolicy sPolicy;
+}
+tModemPolicy;
+
+const tModemPolicy g_psModemPolicies[] =
+{
+    { "AT+CWLAPOPT",    { AT_QUEUE_TIMEOUT_MS, AT_QUEUE_RETRIES } },
+    { "AT+CWLAP",       { 10000, 1 } },
+    { "AT+CWJAP",       { 20000, 0 } },
+    { "AT+CIPSTART",    { 10000, 0 } },
+    { "AT+CIPSEND",     { 2000, 1 } },
+    { "AT+RESTORE",     { 5000, 0 } },
+    { "AT+RST",         { 5000, 0 } },
+    { "AT+UART_CUR",    { AT_QUEUE_TIMEOUT_MS, 0 } },
+};
+
+#define NUM_MODEM_POLICIES      (sizeof(g_psModemPolicies) /                  \
+                                 sizeof(g_psModemPolicies[0]))
+
+const tATPolicy *
+ModemPolicy(const char *pcCommand)
+{
+    uint32_t ui32Index;
+
+    for(ui32Index = 0; ui32Index < NUM_MODEM_POLICIES; ui32Index++)
+    {
+        if(strncmp(pcCommand, g_psModemPolicies[ui32Index].pcPrefix,
+                   strlen(g_psModemPolicies[ui32Index].pcPrefix)) == 0)
+        {
+            return(&g_psModemPolicies[ui32Index].sPolicy);
+        }
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Round trip times of the AT commands, from the command going out to its
+// final result, in microseconds.  Each command has a log-scale histogram so
+// that menu choice 9 can show the median and the tail; commands not listed
+// share the last one.  Replies of ERROR or FAIL count as well, since the
+// module answered; commands that timed out do not.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcName;
+    uint32_t ui32Failed;
+    tHistogram sHistogram;
+}
+tModemLatency;
+
+tModemLatency g_psModemLatency[] =
+{
+    { "CWMODE" },
+    { "CWLAP" },
+    { "CWJAP" },
+    { "CIPSTART" },
+    { "CIPSEND" },
+    { "CIPMODE" },
+    { "CIPMUX" },
+    { "RESTORE" },
+    { "other" },
+};
+
+#define NUM_MODEM_LATENCY       (sizeof(g_psModemLatency) /                   \
+                                 sizeof(g_psModemLatency[0]))
+
+void
+ModemTiming(const char *pcCommand, uint32_t ui32Us, uint32_t ui32Result)
+{
+    tModemLatency *psLatency;
+    uint32_t ui32Length;
+    uint32_t ui32Index;
+
+    //
+    // The name runs from after "AT+" to the '=', '?' or line end.
+    //
+    for(ui32Index = 0; ui32Index < NUM_MODEM_LATENCY - 1; ui32Index++)
+    {
+        ui32Length = strlen(g_psModemLatency[ui32Index].pcName);
+        if((strncmp(pcCommand + 3, g_psModemLatency[ui32Index].pcName,
+                    ui32Length) == 0) &&
+           strchr("=?\r", pcCommand[3 + ui32Length]))
+        {
+            break;
+        }
+    }
+
+    psLatency = &g_psModemLatency[ui32Index];
+    HistogramAdd(&psLatency->sHistogram, ui32Us);
+    if(ui32Result != AT_QUEUE_OK)
+    {
+        psLatency->ui32Failed++;
+    }
+}
+
+//*****************************************************************************
+//
+// The ESP8266 link rate.  AT+UART_CUR answers OK at the old rate and then
+// switches, so the matchers below change the UART over as the OK arrives,
+// before the queue sends anything else.  A restart brings the module back
+// to MODEM_BAUD, as AT+UART_CUR is not saved.
+//
+//*****************************************************************************
+uint32_t g_ui32ModemBaudNext;
+
+void
+ModemBaudApply(uint32_t ui32Baud)
+{
+    if(ui32Baud == g_ui32ModemBaud) {
+        return;
+    }
+
+    //
+    // Let what is queued go out at the old rate first.
+    //
+    while(UARTDMATxBusy(MODEM_UART_BASE) || UARTBusy(MODEM_UART_BASE)) {
+    }
+
+    UARTConfigSetExpClk(MODEM_UART_BASE, UART_CLOCK_HZ, ui32Baud,
+                            (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+                             UART_CONFIG_PAR_NONE));
+    g_ui32ModemBaud = ui32Baud;
+    g_ui32ModemErrors = 0;
+}
+
+uint32_t
+ModemMatchBaud(uint32_t ui32Event)
+{
+    if(ui32Event == AT_EVENT_OK) {
+        ModemBaudApply(g_ui32ModemBaudNext);
+    }
+
+    return(ATQueueMatchOK(ui32Event));
+}
+
+uint32_t
+ModemMatchRestart(uint32_t ui32Event)
+{
+    if(ui32Event == AT_EVENT_OK) {
+        ModemBaudApply(MODEM_BAUD);
+    }
+
+    return(ATQueueMatchReady(ui32Event));
+}
+
+//*****************************************************************************
+//
+// Queue a command.  pfnDone, if not null, is called with the result.
+// Returns false if the queue is full.
+//
+//*****************************************************************************
+bool
+ModemCommand(const char *pcCommand, tATQueueDone pfnDone)
+{
+    return(ATQueueAdd(&g_sATQueue, pcCommand, 0, 0, ATQueueMatchOK,
+                      ModemPolicy(pcCommand), pfnDone, 0));
+}
+
+//*****************************************************************************
+//
+// Queue a command that restarts the module.  It completes once the module
+// reports "ready".
+//
+//*****************************************************************************
+bool
+ModemRestart(const char *pcCommand, tATQueueDone pfnDone)
+{
+    return(ATQueueAdd(&g_sATQueue, pcCommand, 0, 0, ModemMatchRestart,
+                      ModemPolicy(pcCommand), pfnDone, 0));
+}
+
+//*****************************************************************************
+//
+// Hand the queue's next deadline to the SysTick handler.  The flag is
+// cleared while the time changes so the handler never sees half an update.
+//
+//*****************************************************************************
+void
+ModemDeadlineUpdate(void)
+{
+    uint32_t ui32Deadline;
+
+    g_bModemDeadline = false;
+    if(ATQueueDeadline(&g_sATQueue, &ui32Deadline))
+    {
+        g_ui32ModemDeadline = ui32Deadline;
+        g_bModemDeadline = true;
+    }
+}
+
+//*****************************************************************************
+//
+// Link rate negotiation.  ModemBaudNegotiate() first makes sure the module
+// answers at the current rate, probing every rate in g_pui32ModemBauds if it
+// does not, as after a reset of the board alone.  It then asks for each rate
+// from the fastest up to MODEM_BAUD_MAX in turn until one passes a probe.  A
+// rate the module refuses is skipped.  If the probe fails the module is told
+// blind to go back, in case it still hears us, and the old rate is probed
+// again.  pfnDone is called with AT_QUEUE_OK once a rate works.
+//
+// ModemBaudCheck() steps down one rate once MODEM_ERROR_LIMIT receive errors
+// come within MODEM_ERROR_WINDOW_MS, with the module idle.
+//
+//*****************************************************************************
+#ifndef MODEM_BAUD_MAX
+#define MODEM_BAUD_MAX          921600
+#endif
+#define MODEM_PROBE_MS          200
+#define MODEM_REVERT_MS         100
+#define MODEM_ERROR_LIMIT       8
+#define MODEM_ERROR_WINDOW_MS   1000
+
+const uint32_t g_pui32ModemBauds[] =
+{
+    921600, 460800, 230400, MODEM_BAUD
+};
+
+#define NUM_MODEM_BAUDS         (sizeof(g_pui32ModemBauds) / sizeof(g_pui32ModemBauds[0]))
+
+const tATPolicy g_sModemProbePolicy = { MODEM_PROBE_MS, 2 };
+const tATPolicy g_sModemRevertPolicy = { MODEM_REVERT_MS, 0 };
+
+bool g_bModemBaudBusy = false;
+tATQueueDone g_pfnModemBaudDone;
+uint32_t g_ui32ModemBaudIndex;
+uint32_t g_ui32ModemBaudOld;
+uint32_t g_ui32ModemFallbacks = 0;
+uint32_t g_ui32ModemErrorTime;
+
+void ModemBaudTry(void);
+void ModemBaudSearch(void);
+
+void
+ModemProbe(tATQueueDone pfnDone)
+{
+    ATQueueAdd(&g_sATQueue, "AT\r\n", 0, 0, ATQueueMatchOK,
+               &g_sModemProbePolicy, pfnDone, 0);
+}
+
+void
+ModemBaudFinish(uint32_t ui32Result)
+{
+    char text[48];
+    tATQueueDone pfnDone;
+
+    if (ui32Result == AT_QUEUE_OK) {
+        snprintf(text, sizeof(text), "\r\nESP8266 link at %u baud. \r\n", (unsigned int)g_ui32ModemBaud);
+    } else {
+        ModemBaudApply(MODEM_BAUD);
+        snprintf(text, sizeof(text), "\r\nESP8266 does not answer. \r\n");
+    }
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    g_bModemBaudBusy = false;
+    pfnDone = g_pfnModemBaudDone;
+    if (pfnDone) {
+        pfnDone(0, ui32Result);
+    }
+}
+
+void
+ModemBaudSearchDone(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result == AT_QUEUE_OK) {
+        ModemBaudFinish(AT_QUEUE_OK);
+        return;
+    }
+
+    g_ui32ModemBaudIndex++;
+    ModemBaudSearch();
+}
+
+void
+ModemBaudSearch(void)
+{
+    if (g_ui32ModemBaudIndex == NUM_MODEM_BAUDS) {
+        ModemBaudFinish(AT_QUEUE_TIMEOUT);
+        return;
+    }
+
+    ModemBaudApply(g_pui32ModemBauds[g_ui32ModemBaudIndex]);
+    ModemProbe(ModemBaudSearchDone);
+}
+
+void
+ModemBaudRevertProbed(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result != AT_QUEUE_OK) {
+        g_ui32ModemBaudIndex = 0;
+        ModemBaudSearch();
+        return;
+    }
+
+    g_ui32ModemBaudIndex++;
+    ModemBaudTry();
+}
+
+void
+ModemBaudReverted(void *pvArg, uint32_t ui32Result)
+{
+    ModemBaudApply(g_ui32ModemBaudOld);
+    ModemProbe(ModemBaudRevertProbed);
+}
+
+void
+ModemBaudProbed(void *pvArg, uint32_t ui32Result)
+{
+    char text[AT_QUEUE_CMD_SIZE];
+
+    if (ui32Result == AT_QUEUE_OK) {
+        ModemBaudFinish(AT_QUEUE_OK);
+        return;
+    }
+
+    g_ui32ModemFallbacks++;
+    snprintf(text, sizeof(text), "\r\nNo answer at %u baud, going back to %u. \r\n",
+             (unsigned int)g_ui32ModemBaud, (unsigned int)g_ui32ModemBaudOld);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    g_ui32ModemBaudNext = g_ui32ModemBaudOld;
+    snprintf(text, sizeof(text), "AT+UART_CUR=%u,8,1,0,%u\r\n", (unsigned int)g_ui32ModemBaudOld,
+             (unsigned int)MODEM_FLOW);
+    ATQueueAdd(&g_sATQueue, text, 0, 0, ModemMatchBaud,
+               &g_sModemRevertPolicy, ModemBaudReverted, 0);
+}
+
+void
+ModemBaudSet(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result == AT_QUEUE_OK) {
+        ModemProbe(ModemBaudProbed);
+    } else if (ui32Result == AT_QUEUE_FAILED) {
+        g_ui32ModemBaudIndex++;
+        ModemBaudTry();
+    } else {
+        g_ui32ModemBaudIndex = 0;
+        ModemBaudSearch();
+    }
+}
+
+void
+ModemBaudTry(void)
+{
+    char text[AT_QUEUE_CMD_SIZE];
+
+    while (g_ui32ModemBaudIndex < NUM_MODEM_BAUDS &&
+           g_pui32ModemBauds[g_ui32ModemBaudIndex] > MODEM_BAUD_MAX) {
+        g_ui32ModemBaudIndex++;
+    }
+
+    //
+    // With flow control the command is sent even at the rate in use, as it
+    // is also what turns the module's RTS and CTS on after a reset.
+    //
+    if (g_ui32ModemBaudIndex == NUM_MODEM_BAUDS ||
+        (g_pui32ModemBauds[g_ui32ModemBaudIndex] == g_ui32ModemBaud &&
+         !MODEM_FLOW)) {
+        ModemBaudFinish(AT_QUEUE_OK);
+        return;
+    }
+
+    g_ui32ModemBaudOld = g_ui32ModemBaud;
+    g_ui32ModemBaudNext = g_pui32ModemBauds[g_ui32ModemBaudIndex];
+    snprintf(text, sizeof(text), "AT+UART_CUR=%u,8,1,0,%u\r\n", (unsigned int)g_ui32ModemBaudNext,
+             (unsigned int)MODEM_FLOW);
+    ATQueueAdd(&g_sATQueue, text, 0, 0, ModemMatchBaud,
+               ModemPolicy(text), ModemBaudSet, 0);
+}
+
+void
+ModemBaudFound(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result != AT_QUEUE_OK) {
+        g_ui32ModemBaudIndex = 0;
+        ModemBaudSearch();
+        return;
+    }
+
+    g_ui32ModemBaudIndex = 0;
+    ModemBaudTry();
+}
+
+void
+ModemBaudNegotiate(tATQueueDone pfnDone)
+{
+    g_bModemBaudBusy = true;
+    g_pfnModemBaudDone = pfnDone;
+    ModemProbe(ModemBaudFound);
+}
+
+void
+ModemBaudCheck(void)
+{
+    uint32_t ui32Index;
+
+    if (g_ui32ModemErrors >= MODEM_ERROR_LIMIT && g_ui32ModemBaud > MODEM_BAUD &&
+        !g_bModemBaudBusy && !g_bModemRaw && ATQueueDepth(&g_sATQueue) == 0) {
+        for (ui32Index = 0; g_pui32ModemBauds[ui32Index] >= g_ui32ModemBaud; ui32Index++) {
+        }
+        g_ui32ModemFallbacks++;
+        g_bModemBaudBusy = true;
+        g_pfnModemBaudDone = 0;
+        g_ui32ModemBaudIndex = ui32Index;
+        ModemBaudTry();
+    }
+
+    if ((int32_t)(ClockMs() - g_ui32ModemErrorTime) >= MODEM_ERROR_WINDOW_MS) {
+        g_ui32ModemErrorTime = ClockMs();
+        g_ui32ModemErrors = 0;
+    }
+}
+
+//*****************************************************************************
+//
+// Queue data to send over a TCP link.  The payload follows the "> " prompt
+// at once, and pfnDone is called with AT_QUEUE_OK if the module reported
+// SEND OK.  The data must stay in place until then.  The link ID is only
+// sent with multiple connections on.  Returns false if the queue is full.
+//
+// With no data, sends a bare AT+CIPSEND and completes at the prompt, which
+// is how transparent transmission is started.
+//
+//*****************************************************************************
+bool
+ModemLinkSend(uint32_t ui32Link, const uint8_t *pui8Data, uint32_t ui32Count,
+              tATQueueDone pfnDone)
+{
+    char pcCommand[24];
+
+    if(pui8Data && g_bMux)
+    {
+        snprintf(pcCommand, sizeof(pcCommand), "AT+CIPSEND=%u,%u\r\n",
+                 (unsigned int)ui32Link, (unsigned int)ui32Count);
+    }
+    else if(pui8Data)
+    {
+        snprintf(pcCommand, sizeof(pcCommand), "AT+CIPSEND=%u\r\n",
+                 (unsigned int)ui32Count);
+    }
+    else
+    {
+        strcpy(pcCommand, "AT+CIPSEND\r\n");
+    }
+
+    return(ATQueueAdd(&g_sATQueue, pcCommand, pui8Data, ui32Count,
+                      ATQueueMatchSend, ModemPolicy(pcCommand), pfnDone, 0));
+}
+
+bool
+ModemSend(const uint8_t *pui8Data, uint32_t ui32Count, tATQueueDone pfnDone)
+{
+    return(ModemLinkSend(0, pui8Data, ui32Count, pfnDone));
+}
+
+//*****************************************************************************
+//
+// Print what has been received on each link, then, unless a link's send is
+// still under way, give the next link with queued data its turn to send.
+// Received data is labelled with its link whenever the link printed changes.
+//
+//*****************************************************************************
+uint32_t g_ui32LinkShown = LINK_MUX_NONE;
+uint32_t g_ui32LinkSending;
+uint32_t g_ui32LinkSendCount;
+bool g_bLinkSending = false;
+
+void
+LinksSent(void *pvArg, uint32_t ui32Result)
+{
+    LinkMuxSent(&g_sLinks, g_ui32LinkSending,
+                (ui32Result == AT_QUEUE_OK) ? g_ui32LinkSendCount : 0);
+    g_bLinkSending = false;
+}
+
+void
+LinksService(void)
+{
+    char text[16];
+    uint8_t *pui8Data;
+    uint32_t ui32Link;
+    uint32_t ui32Count;
+
+    for(ui32Link = 0; ui32Link < LINK_MUX_LINKS; ui32Link++) {
+        ui32Count = RingBufReadSpan(&g_sLinks.psLinks[ui32Link].sRx, &pui8Data);
+        if(ui32Count == 0) {
+            continue;
+        }
+
+        if(ui32Link != g_ui32LinkShown) {
+            snprintf(text, sizeof(text), "\r\n[%u] ", (unsigned int)ui32Link);
+            UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+            g_ui32LinkShown = ui32Link;
+        }
+        UARTSend(UART0_BASE, pui8Data, ui32Count);
+        RingBufAdvance(&g_sLinks.psLinks[ui32Link].sRx, ui32Count);
+    }
+
+    if(g_bLinkSending) {
+        return;
+    }
+
+    ui32Link = LinkMuxNext(&g_sLinks, &pui8Data, &ui32Count);
+    if(ui32Link == LINK_MUX_NONE) {
+        return;
+    }
+
+    g_ui32LinkSending = ui32Link;
+    g_ui32LinkSendCount = ui32Count;
+    g_bLinkSending = ModemLinkSend(ui32Link, pui8Data, ui32Count, LinksSent);
+}
+
+//*****************************************************************************
+//
+// Turn multiple connections on or off.  The module refuses while any link is
+// open.  pfnDone is called with the outcome.  Returns false if the queue is
+// full, in which case pfnDone is not called.
+//
+//*****************************************************************************
+bool g_bMuxWanted;
+tATQueueDone g_pfnMuxDone;
+
+void
+LinksMuxDone(void *pvArg, uint32_t ui32Result)
+{
+    if(ui32Result == AT_QUEUE_OK) {
+        g_bMux = g_bMuxWanted;
+        g_ui32Link = 0;
+        ATParserMuxSet(&g_sATParser, g_bMux);
+        g_pfnPayloadHandler = g_bMux ? PayloadToLink : PayloadToConsole;
+    }
+
+    if(g_pfnMuxDone) {
+        g_pfnMuxDone(pvArg, ui32Result);
+    }
+}
+
+bool
+LinksMuxSet(bool bMux, tATQueueDone pfnDone)
+{
+    g_bMuxWanted = bMux;
+    g_pfnMuxDone = pfnDone;
+    return(ModemCommand(bMux ? "AT+CIPMUX=1\r\n" : "AT+CIPMUX=0\r\n", LinksMuxDone));
+}
+
+//*****************************************************************************
+//
+// Optional coalescing of passthrough messages.  While g_ui32CoalesceMs is
+// non-zero, lines are packed into one AT+CIPSEND and flushed when the buffer
+// fills, when the oldest line has waited that many milliseconds (timed by
+// Timer 2A), or when "++flush" is typed.
+//
+// Lines sent on their own are copied to g_pui8LineBuf first, so the next
+// line can be typed while one is still going out.
+//
+//*****************************************************************************
+#define COALESCE_DEFAULT_MS     20
+#define LINE_SIZE               128
+
+uint8_t g_pui8CoalesceBuf[COALESCE_MAX_SEND];
+tCoalesce g_sCoalesce;
+uint32_t g_ui32CoalesceMs = 0;
+uint32_t g_ui32FlushReason;
+bool g_bFlushing = false;
+uint8_t g_pui8LineBuf[LINE_SIZE];
+bool g_bLineSending = false;
+
+//*****************************************************************************
+//
+// The coalescing flush timer interrupt handler.
+//
+//*****************************************************************************
+void
+CoalesceTimerIntHandler(void)
+{
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
+
+    TimerIntClear(TIMER2_BASE, TIMER_TIMA_TIMEOUT);
+    g_sCoalesceTimer.bArmed = false;
+    CoalesceTimeout(&g_sCoalesce);
+    EventPost(&g_sEvents, EVENT_COALESCE);
+
+    PROFILE_END(&g_sCoalesceTimerProfile, ui32Start);
+}
+
+//*****************************************************************************
+//
+// Start sending the waiting passthrough messages.  The buffer is emptied,
+// and can take messages again, once the send is done.
+//
+//*****************************************************************************
+void
+PassthroughSent(void *pvArg, uint32_t ui32Result)
+{
+    if(ui32Result != AT_QUEUE_OK) {
+        UARTSend(UART0_BASE, (uint8_t *)"Send failed. \r\n", strlen("Send failed. \r\n"));
+    }
+
+    g_bLineSending = false;
+}
+
+void
+PassthroughFlushed(void *pvArg, uint32_t ui32Result)
+{
+    if(ui32Result != AT_QUEUE_OK) {
+        UARTSend(UART0_BASE, (uint8_t *)"Send failed. \r\n", strlen("Send failed. \r\n"));
+    }
+
+    CoalesceSent(&g_sCoalesce, g_ui32FlushReason);
+    g_bFlushing = false;
+}
+
+void
+PassthroughFlush(uint32_t ui32Reason)
+{
+    uint8_t *pui8Data;
+    uint32_t ui32Count;
+
+    if(g_bFlushing) {
+        return;
+    }
+
+    OneShotStop(&g_sCoalesceTimer);
+
+    ui32Count = CoalescePending(&g_sCoalesce, &pui8Data);
+    if(ui32Count == 0) {
+        CoalesceSent(&g_sCoalesce, ui32Reason);
+        return;
+    }
+
+    g_ui32FlushReason = ui32Reason;
+    g_bFlushing = ModemSend(pui8Data, ui32Count, PassthroughFlushed);
+}
+
+//*****************************************************************************
+//
+// Send a passthrough message, directly or through the coalescing buffer.
+// Returns false if the message has to wait for a send to make room, in which
+// case it is offered again later.
+//
+//*****************************************************************************
+bool
+PassthroughSend(const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    //
+    // With multiple connections the message is queued on the selected link
+    // and followed by the same separator coalesced messages get.
+    //
+    if(g_bMux) {
+        if(!LinkMuxIsOpen(&g_sLinks, g_ui32Link)) {
+            UARTSend(UART0_BASE, (uint8_t *)"Link is not open. \r\n", strlen("Link is not open. \r\n"));
+            return(true);
+        }
+        if(RingBufFree(&g_sLinks.psLinks[g_ui32Link].sTx) < ui32Count + 1) {
+            return(false);
+        }
+        LinkMuxQueue(&g_sLinks, g_ui32Link, pui8Data, ui32Count);
+        LinkMuxQueue(&g_sLinks, g_ui32Link, (uint8_t *)"\n", 1);
+        return(true);
+    }
+
+    if(g_ui32CoalesceMs == 0 || ui32Count >= g_sCoalesce.ui32Size) {
+        if(g_bLineSending) {
+            return(false);
+        }
+        memcpy(g_pui8LineBuf, pui8Data, ui32Count);
+        g_bLineSending = ModemSend(g_pui8LineBuf, ui32Count, PassthroughSent);
+        return(g_bLineSending);
+    }
+
+    if(g_bFlushing) {
+        return(false);
+    }
+
+    if(!CoalesceFits(&g_sCoalesce, ui32Count)) {
+        PassthroughFlush(COALESCE_FLUSH_SIZE);
+        return(false);
+    }
+
+    CoalesceAdd(&g_sCoalesce, pui8Data, ui32Count);
+
+    //
+    // The first message into an empty buffer starts the flush timer.
+    //
+    if(g_sCoalesce.ui32Messages == 1) {
+        OneShotStart(&g_sCoalesceTimer, g_ui32CoalesceMs);
+    }
+
+    if(!CoalesceFits(&g_sCoalesce, 0)) {
+        PassthroughFlush(COALESCE_FLUSH_SIZE);
+    }
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Print the coalescing counters on the console.
+//
+//*****************************************************************************
+void
+PassthroughStats(void)
+{
+    char text[160];
+    uint32_t ui32Mean;
+    uint32_t ui32Link;
+    tLink *psLink;
+
+    ui32Mean = g_sCoalesce.ui32Sends ?
+               (g_sCoalesce.ui32SentMessages * 10) / g_sCoalesce.ui32Sends : 0;
+
+    snprintf(text, sizeof(text), "sends %u, messages %u, bytes %u, messages/send %u.%u max %u, flushes size %u timer %u marker %u\r\n",
+             (unsigned int)g_sCoalesce.ui32Sends,
+             (unsigned int)g_sCoalesce.ui32SentMessages,
+             (unsigned int)g_sCoalesce.ui32SentBytes,
+             (unsigned int)(ui32Mean / 10), (unsigned int)(ui32Mean % 10),
+             (unsigned int)g_sCoalesce.ui32MaxMessages,
+             (unsigned int)g_sCoalesce.ui32Flushes[COALESCE_FLUSH_SIZE],
+             (unsigned int)g_sCoalesce.ui32Flushes[COALESCE_FLUSH_TIMER],
+             (unsigned int)g_sCoalesce.ui32Flushes[COALESCE_FLUSH_MARKER]);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    snprintf(text, sizeof(text), "events %u, merged %u, sleeps %u\r\n",
+             (unsigned int)g_sEvents.ui32Posted,
+             (unsigned int)g_sEvents.ui32Merged,
+             (unsigned int)g_sEvents.ui32Sleeps);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    snprintf(text, sizeof(text), "commands %u, failed %u, refused %u, depth %u max %u, wait mean %u max %u ms, run mean %u max %u ms\r\n",
+             (unsigned int)g_sATQueue.ui32Commands,
+             (unsigned int)g_sATQueue.ui32Failed,
+             (unsigned int)g_sATQueue.ui32Refused,
+             (unsigned int)ATQueueDepth(&g_sATQueue),
+             (unsigned int)g_sATQueue.ui32MaxDepth,
+             (unsigned int)(g_sATQueue.ui32Commands ? g_sATQueue.ui32WaitTotal / g_sATQueue.ui32Commands : 0),
+             (unsigned int)g_sATQueue.ui32WaitMax,
+             (unsigned int)(g_sATQueue.ui32Commands ? g_sATQueue.ui32RunTotal / g_sATQueue.ui32Commands : 0),
+             (unsigned int)g_sATQueue.ui32RunMax);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    snprintf(text, sizeof(text), "timeouts %u, retries %u, stalls %u, recovery last %u max %u ms, uptime %u ms\r\n",
+             (unsigned int)g_sATQueue.ui32Timeouts,
+             (unsigned int)g_sATQueue.ui32Retries,
+             (unsigned int)g_sATQueue.ui32Stalls,
+             (unsigned int)g_sATQueue.ui32StallLast,
+             (unsigned int)g_sATQueue.ui32StallMax,
+             (unsigned int)ClockMs());
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    snprintf(text, sizeof(text), "link %u baud, fallbacks %u, rx held %u, overruns %u, dropped %u\r\n",
+             (unsigned int)g_ui32ModemBaud,
+             (unsigned int)g_ui32ModemFallbacks,
+             (unsigned int)UARTDMARxHolds(MODEM_UART_BASE),
+             (unsigned int)g_ui32ModemOverruns,
+             (unsigned int)g_sModemRxRing.ui32Dropped);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    snprintf(text, sizeof(text), "console dropped %u, overruns %u\r\n",
+             (unsigned int)g_sUART0RxRing.ui32Dropped,
+             (unsigned int)g_ui32ConsoleOverruns);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    if(!g_bMux) {
+        return;
+    }
+
+    for(ui32Link = 0; ui32Link < LINK_MUX_LINKS; ui32Link++) {
+        psLink = &g_sLinks.psLinks[ui32Link];
+
+        snprintf(text, sizeof(text), "link %u%s: %s, sends %u, sent %u, queued %u, received %u\r\n",
+                 (unsigned int)ui32Link, (ui32Link == g_ui32Link) ? " (selected)" : "",
+                 psLink->bOpen ? "open" : "closed",
+                 (unsigned int)psLink->ui32Sends,
+                 (unsigned int)psLink->ui32TxBytes,
+                 (unsigned int)RingBufUsed(&psLink->sTx),
+                 (unsigned int)psLink->ui32RxBytes);
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    }
+}
+
+//*****************************************************************************
+//
+// The console user interface.  Nothing in it waits: each state takes input
+// from the console when there is some and the module is free.  A state that
+// needs the module starts a command and moves to UI_BUSY, and the command's
+// completion function picks the next state.
+//
+//*****************************************************************************
+#define UI_MENU                 0
+#define UI_BUSY                 1
+#define UI_SSID                 2
+#define UI_PASSWORD             3
+#define UI_PORT                 4
+#define UI_IP                   5
+#define UI_PASSTHROUGH          6
+#define UI_TRANSPARENT          7
+#define UI_TRANSPARENT_EXIT     8
+
+uint32_t g_ui32UIState = UI_MENU;
+
+//*****************************************************************************
+//
+// Print the menu and wait for a choice.
+//
+//*****************************************************************************
+void
+UIMenu(void)
+{
+    UARTSend(UART0_BASE, (uint8_t *)"Command List:\r\n 1. Set mode \r\n 2. Connect to WiFi \r\n 3. Choose port for communication \r\n 4. Enter passthrough mode \r\n 5. Restore Factory Default Settings\r\n 6. Enter transparent mode \r\n 7. Toggle multiple connections \r\n 8. Show profile \r\n 9. Show command latency \r\n",
+                    strlen("Command List:\r\n 1. Set mode \r\n 2. Connect to WiFi \r\n 3. Choose port for communication \r\n 4. Enter passthrough mode \r\n 5. Restore Factory Default Settings\r\n 6. Enter transparent mode \r\n 7. Toggle multiple connections \r\n 8. Show profile \r\n 9. Show command latency \r\n"));
+
+    g_ui32UIState = UI_MENU;
+}
+
+//*****************************************************************************
+//
+// The result line ends the command at its carriage return, so the line feed
+// is supplied here before anything else is printed.  A command that timed
+// out has no result line of its own, so that is said instead.
+//
+//*****************************************************************************
+void
+UIResult(uint32_t ui32Result)
+{
+    UARTSend(UART0_BASE, (uint8_t *)"\r\n", 2);
+
+    if (ui32Result == AT_QUEUE_TIMEOUT) {
+        UARTSend(UART0_BASE, (uint8_t *)"No answer from the module. \r\n", strlen("No answer from the module. \r\n"));
+    }
+}
+
+void
+UIMenuDone(void *pvArg, uint32_t ui32Result)
+{
+    UIResult(ui32Result);
+    UIMenu();
+}
+
+//*****************************************************************************
+//
+// Queue a command built from what was typed or saved, where iLength is what
+// snprintf() returned for it.  A command that was cut short to fit, or that
+// the queue refuses, is not sent; the menu comes back instead of waiting for
+// an answer that will never come.  UIRefused() does the same for a command
+// queued some other way.
+//
+//*****************************************************************************
+void
+UIRefused(void)
+{
+    UARTSend(UART0_BASE, (uint8_t *)"\r\nCommand too long or queue full, not sent. \r\n", strlen("\r\nCommand too long or queue full, not sent. \r\n"));
+    UIMenu();
+}
+
+bool
+UICommand(const char *pcCommand, int iLength, tATQueueDone pfnDone)
+{
+    if (iLength < 0 || iLength >= AT_QUEUE_CMD_SIZE || !ModemCommand(pcCommand, pfnDone)) {
+        UIRefused();
+        return(false);
+    }
+
+    return(true);
+}
+
+//*****************************************************************************
+//
+// Transparent transmission.  The module is put in AT+CIPMODE=1 and bytes are
+// copied between the console and the module untouched until the escape
+// sequence: nothing typed for TRANSPARENT_GUARD_MS, "+++", and nothing typed
+// for TRANSPARENT_GUARD_MS again.  The pluses are held back while the escape
+// may still be forming, so a "+++" inside the data goes through as data.
+// The module's own escape rule is the same: it leaves transparent mode on a
+// "+++" that arrives as a packet of its own, after which it wants a second
+// before the next command.
+//
+// Wide Timer 5A measures the guard time, restarted by every console byte.
+//
+//*****************************************************************************
+#define TRANSPARENT_GUARD_MS    1000
+#define TRANSPARENT_EXIT_MS     1000
+
+volatile bool g_bGuardExpired;
+uint32_t g_ui32Plus;
+bool g_bIdle;
+
+//*****************************************************************************
+//
+// The escape guard timer interrupt handler.
+//
+//*****************************************************************************
+void
+GuardTimerIntHandler(void)
+{
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
+
+    TimerIntClear(WTIMER5_BASE, TIMER_TIMA_TIMEOUT);
+    g_sGuardTimer.bArmed = false;
+    g_bGuardExpired = true;
+    EventPost(&g_sEvents, EVENT_GUARD);
+
+    PROFILE_END(&g_sGuardTimerProfile, ui32Start);
+}
+
+//*****************************************************************************
+//
+// Start a guard period of the given length.  An expiry already posted for
+// an earlier period is ignored, as g_bGuardExpired is cleared here.
+//
+//*****************************************************************************
+void
+GuardTimerStart(uint32_t ui32Ms)
+{
+    OneShotStop(&g_sGuardTimer);
+    g_bGuardExpired = false;
+    OneShotStart(&g_sGuardTimer, ui32Ms);
+}
+
+void
+TransparentFailed(void *pvArg, uint32_t ui32Result)
+{
+    UARTSend(UART0_BASE, (uint8_t *)"\r\nCould not enter transparent mode. \r\n", strlen("\r\nCould not enter transparent mode. \r\n"));
+    UIMenu();
+}
+
+void
+TransparentLeft(void *pvArg, uint32_t ui32Result)
+{
+    UARTSend(UART0_BASE, (uint8_t *)"\r\nLeft transparent mode. \r\n", strlen("\r\nLeft transparent mode. \r\n"));
+    UIMenu();
+}
+
+//*****************************************************************************
+//
+// The module has prompted for transparent data.  From here on its output is
+// copied to the console by ModemPoll().
+//
+//*****************************************************************************
+void
+TransparentStarted(void *pvArg, uint32_t ui32Result)
+{
+    if(ui32Result != AT_QUEUE_OK) {
+        UICommand("AT+CIPMODE=0\r\n", strlen("AT+CIPMODE=0\r\n"), TransparentFailed);
+        return;
+    }
+
+    UARTSend(UART0_BASE, (uint8_t *)"\r\nTransparent mode. Pause, type +++, pause to exit. \r\n", strlen("\r\nTransparent mode. Pause, type +++, pause to exit. \r\n"));
+
+    g_ui32Plus = 0;
+    g_bIdle = false;
+    g_bModemRaw = true;
+    GuardTimerStart(TRANSPARENT_GUARD_MS);
+    g_ui32UIState = UI_TRANSPARENT;
+}
+
+//*****************************************************************************
+//
+// Start transparent transmission.  A TCP link must already be open.  Both
+// commands are queued at once; if the first fails the module refuses the
+// bare AT+CIPSEND too, and TransparentStarted() sets the mode back.
+//
+//*****************************************************************************
+void
+TransparentMode(void)
+{
+    g_ui32UIState = UI_BUSY;
+    if(!UICommand("AT+CIPMODE=1\r\n", strlen("AT+CIPMODE=1\r\n"), 0)) {
+        return;
+    }
+    if(!ModemSend(0, 0, TransparentStarted)) {
+        TransparentStarted(0, AT_QUEUE_FAILED);
+    }
+}
+
+//*****************************************************************************
+//
+// Copy what has been typed to the module, holding back pluses that may be
+// the start of the escape sequence.
+//
+//*****************************************************************************
+void
+TransparentInput(void)
+{
+    uint8_t pui8Buf[32];
+    uint32_t ui32Count;
+    uint8_t ui8Char;
+
+    ui32Count = 0;
+    while(RingBufGet(&g_sUART0RxRing, &ui8Char))
+    {
+        GuardTimerStart(TRANSPARENT_GUARD_MS);
+
+        if((ui8Char == '+') && (g_bIdle || g_ui32Plus) && (g_ui32Plus < 3))
+        {
+            g_ui32Plus++;
+            g_bIdle = false;
+            continue;
+        }
+
+        //
+        // Not an escape after all; release the held pluses.
+        //
+        while(g_ui32Plus)
+        {
+            pui8Buf[ui32Count++] = '+';
+            g_ui32Plus--;
+            if(ui32Count == sizeof(pui8Buf))
+            {
+                UARTSend(MODEM_UART_BASE, pui8Buf, ui32Count);
+                ui32Count = 0;
+            }
+        }
+
+        g_bIdle = false;
+        pui8Buf[ui32Count++] = ui8Char;
+        if(ui32Count == sizeof(pui8Buf))
+        {
+            UARTSend(MODEM_UART_BASE, pui8Buf, ui32Count);
+            ui32Count = 0;
+        }
+    }
+
+    if(ui32Count)
+    {
+        UARTSend(MODEM_UART_BASE, pui8Buf, ui32Count);
+    }
+}
+
+//*****************************************************************************
+//
+// A guard period has passed with nothing typed.
+//
+//*****************************************************************************
+void
+TransparentGuard(void)
+{
+    if(g_ui32UIState == UI_TRANSPARENT)
+    {
+        //
+        // The console and so the module line have been quiet for a guard
+        // time either side of "+++".  Send the escape on its own, then give
+        // the module time to leave transparent mode before the next command.
+        //
+        if(g_ui32Plus == 3)
+        {
+            UARTSend(MODEM_UART_BASE, (uint8_t *)"+++", 3);
+            GuardTimerStart(TRANSPARENT_EXIT_MS);
+            g_ui32UIState = UI_TRANSPARENT_EXIT;
+            return;
+        }
+
+        //
+        // Too slow for an escape; the held pluses are data.
+        //
+        if(g_ui32Plus)
+        {
+            UARTSend(MODEM_UART_BASE, (uint8_t *)"+++", g_ui32Plus);
+            g_ui32Plus = 0;
+        }
+
+        g_bIdle = true;
+    }
+    else if(g_ui32UIState == UI_TRANSPARENT_EXIT)
+    {
+        g_bModemRaw = false;
+        ATParserInit(&g_sATParser);
+        ATParserMuxSet(&g_sATParser, g_bMux);
+
+        g_ui32UIState = UI_BUSY;
+        UICommand("AT+CIPMODE=0\r\n", strlen("AT+CIPMODE=0\r\n"), TransparentLeft);
+    }
+}
+
+//*****************************************************************************
+//
+// The Button0 interrupt handler.
+//
+//*****************************************************************************
+void
+Button0IntHandler(void)
+{
+    uint32_t status = 0;
+    uint32_t ui32Start;
+
+    PROFILE_START(ui32Start);
+
+    status = GPIOIntStatus(BUTTONS_GPIO_BASE, true);
+    GPIOIntClear(BUTTONS_GPIO_BASE, status);
+
+    if (status & GPIO_INT_PIN_4){
+        EventPost(&g_sEvents, EVENT_BUTTON);
+    }
+
+    PROFILE_END(&g_sButton0Profile, ui32Start);
+}
+
+//*****************************************************************************
+//
+// Toggle the LED on a press of Button0.
+//
+//*****************************************************************************
+void
+ButtonPressed(void)
+{
+    uint8_t  value = GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_3);
+
+    if (value == 0)
+      GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, GPIO_PIN_3);
+    else
+      GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, 0);
+}
+
+//*****************************************************************************
+//
+// Completion functions for the menu commands.
+//
+//*****************************************************************************
+int chosen_network;
+int port_number;
+
+//*****************************************************************************
+//
+// The last network joined and server connected to, kept in EEPROM so that
+// the firmware can join and connect by itself after a reset.  What the menus
+// are given collects in g_sSettingsNext and is only written once the module
+// has accepted it.  The BSSID of the access point chosen is passed to
+// AT+CWJAP when rejoining, so the module goes straight to it.
+//
+//*****************************************************************************
+tSettings g_sSettings;
+tSettings g_sSettingsNext;
+bool g_bSettings = false;
+
+void
+UISettingsSave(void)
+{
+    if (g_bSettings && !SettingsSave(&g_sSettings)) {
+        UARTSend(UART0_BASE, (uint8_t *)"Could not save settings. \r\n", strlen("Could not save settings. \r\n"));
+    }
+}
+
+void
+UIJoinDone(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result == AT_QUEUE_OK) {
+        memcpy(g_sSettings.pcSSID, g_sSettingsNext.pcSSID, sizeof(g_sSettings.pcSSID));
+        memcpy(g_sSettings.pcPassword, g_sSettingsNext.pcPassword, sizeof(g_sSettings.pcPassword));
+        memcpy(g_sSettings.pui8BSSID, g_sSettingsNext.pui8BSSID, sizeof(g_sSettings.pui8BSSID));
+        g_sSettings.ui8Channel = g_sSettingsNext.ui8Channel;
+        UISettingsSave();
+    }
+
+    UIMenuDone(pvArg, ui32Result);
+}
+
+void
+UIScanList(void)
+{
+    const tScanRecord *psRecord;
+    char text[64];
+    int i;
+
+    for(i = 0; i < ScanListCount(&g_sScanList); i++) {
+        psRecord = ScanListGet(&g_sScanList, i);
+
+        snprintf(text, sizeof(text), "%d. ", i+1);
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+        UARTSend(UART0_BASE, (uint8_t *)psRecord->pcSSID, strlen(psRecord->pcSSID));
+        snprintf(text, sizeof(text), " (%d dBm, channel %u)\n\r", psRecord->i8RSSI, psRecord->ui8Channel);
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    }
+
+    snprintf(text, sizeof(text), "Scanned %u s ago. \n\r", (unsigned int)((ClockMs() - g_ui32ScanTime) / 1000));
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    UARTSend(UART0_BASE, (uint8_t *)"Choose network: \n\r Type r to scan again \n\r Type 0 to exit \n\r", strlen("Choose network: \n\r Type r to scan again \n\r Type 0 to exit \n\r"));
+
+    g_ui32UIState = UI_SSID;
+}
+
+void
+UIScanDone(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result != AT_QUEUE_OK) {
+        listing_networks = 0;
+        ATParserLineBufferSet(&g_sATParser, 0, 0);
+        g_bScanValid = false;
+        UIResult(ui32Result);
+        UIMenu();
+        return;
+    }
+
+    g_bScanValid = true;
+    g_ui32ScanTime = ClockMs();
+    UIScanList();
+}
+
+void
+UIScanOptionsDone(void *pvArg, uint32_t ui32Result)
+{
+    if (ui32Result == AT_QUEUE_OK) {
+        g_bScanOptions = true;
+    }
+}
+
+void
+UIScan(void)
+{
+    g_ui32UIState = UI_BUSY;
+    if (!UICommand("AT+CWMODE=3\r\n", strlen("AT+CWMODE=3\r\n"), 0)) {
+        return;
+    }
+    if (!g_bScanOptions && !UICommand("AT+CWLAPOPT=1," SCAN_FIELDS "\r\n", strlen("AT+CWLAPOPT=1," SCAN_FIELDS "\r\n"), UIScanOptionsDone)) {
+        return;
+    }
+    UICommand("AT+CWLAP\r\n", strlen("AT+CWLAP\r\n"), UIScanDone);
+}
+
+void
+UIConnectDone(void *pvArg, uint32_t ui32Result)
 {
-    int i;
-    for(i = 0; i < 32; i++) {
-        ssid_list[index][i] = name[i];
+    char text[32];
+
+    UIResult(ui32Result);
+
+    if (ui32Result == AT_QUEUE_OK) {
+        memcpy(g_sSettings.pcHost, g_sSettingsNext.pcHost, sizeof(g_sSettings.pcHost));
+        g_sSettings.ui16Port = g_sSettingsNext.ui16Port;
+        UISettingsSave();
+    }
+
+    if (g_bMux && LinkMuxIsOpen(&g_sLinks, g_ui32Link)) {
+        snprintf(text, sizeof(text), "Link %u selected. \r\n", (unsigned int)g_ui32Link);
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    }
+
+    UIMenu();
+}
+
+void
+UIMuxDone(void *pvArg, uint32_t ui32Result)
+{
+    UIResult(ui32Result);
+
+    if (ui32Result == AT_QUEUE_FAILED) {
+        UARTSend(UART0_BASE, (uint8_t *)"Close all connections first. \r\n", strlen("Close all connections first. \r\n"));
     }
+
+    UARTSend(UART0_BASE, (uint8_t *)(g_bMux ? "Multiple connections on. \r\n" : "Multiple connections off. \r\n"),
+                         strlen(g_bMux ? "Multiple connections on. \r\n" : "Multiple connections off. \r\n"));
+    UIMenu();
 }
 
 //*****************************************************************************
 //
-// Get a particular SSID from the list with SSID's
+// Join the network in the saved settings and connect to the saved server,
+// as menu choices 2 and 3 would.  AT firmware 1.x takes no channel with
+// AT+CWJAP, only the BSSID; a command too long for the queue with the BSSID
+// goes without it.
 //
 //*****************************************************************************
-char* get(int index)
+void
+UIRejoinDone(void *pvArg, uint32_t ui32Result)
+{
+    char text[AT_QUEUE_CMD_SIZE];
+    int length;
+
+    UIResult(ui32Result);
+
+    if (ui32Result != AT_QUEUE_OK || g_sSettings.ui16Port == 0) {
+        UIMenu();
+        return;
+    }
+
+    snprintf(text, sizeof(text), "Connecting to %s:%u. \r\n", g_sSettings.pcHost, g_sSettings.ui16Port);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    port_number = g_sSettings.ui16Port;
+    length = snprintf(text, sizeof(text), "AT+CIPSTART=\"TCP\",\"%s\",%d\r\n", g_sSettings.pcHost, port_number);
+    UICommand(text, length, UIConnectDone);
+}
+
+void
+UIRejoin(void)
 {
-    return ssid_list[index];
+    char text[AT_QUEUE_CMD_SIZE];
+    const uint8_t *pui8BSSID;
+    int length;
+
+    g_sSettingsNext = g_sSettings;
+
+    snprintf(text, sizeof(text), "Joining %s on channel %u. \r\n", g_sSettings.pcSSID, g_sSettings.ui8Channel);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    pui8BSSID = g_sSettings.pui8BSSID;
+    length = sizeof(text);
+    if (pui8BSSID[0] | pui8BSSID[1] | pui8BSSID[2] | pui8BSSID[3] | pui8BSSID[4] | pui8BSSID[5]) {
+        length = snprintf(text, sizeof(text), "AT+CWJAP=\"%s\",\"%s\",\"%02x:%02x:%02x:%02x:%02x:%02x\"\r\n",
+                          g_sSettings.pcSSID, g_sSettings.pcPassword,
+                          pui8BSSID[0], pui8BSSID[1], pui8BSSID[2], pui8BSSID[3], pui8BSSID[4], pui8BSSID[5]);
+    }
+    if (length >= sizeof(text)) {
+        length = snprintf(text, sizeof(text), "AT+CWJAP=\"%s\",\"%s\"\r\n", g_sSettings.pcSSID, g_sSettings.pcPassword);
+    }
+
+    g_ui32UIState = UI_BUSY;
+    if (!UICommand("AT+CWMODE=3\r\n", strlen("AT+CWMODE=3\r\n"), 0)) {
+        return;
+    }
+    UICommand(text, length, UIRejoinDone);
 }
+
 //*****************************************************************************
 //
-// The UART5 interrupt handler.
+// Once the link rate is settled, rejoin the network saved in EEPROM, if
+// there is one.
 //
 //*****************************************************************************
-char command [256] = "";
-int without_echo = 0;
-int passthrough_mode = 0;
+void
+UIStart(void *pvArg, uint32_t ui32Result)
+{
+    if (g_sSettings.pcSSID[0]) {
+        UIRejoin();
+    } else {
+        UIMenu();
+    }
+}
 
-char ssid_entry[32][128];
-int listing_networks = 0;
-int num_ssid = 0;
-int command_size = 0;
-int ssid_size = 0;
-int command_finished = 0;
+//*****************************************************************************
+//
+// The module has restarted with its factory settings, so multiple
+// connections are off, no link is open and the link is back at MODEM_BAUD,
+// to be negotiated again.
+//
+//*****************************************************************************
 void
-UART5IntHandler(void)
+UIRestoreDone(void *pvArg, uint32_t ui32Result)
 {
-    uint32_t ui32Status;
+    UIResult(ui32Result);
+
+    if (ui32Result == AT_QUEUE_OK) {
+        g_bMux = false;
+        g_ui32Link = 0;
+        ATParserMuxSet(&g_sATParser, false);
+        LinkMuxInit(&g_sLinks, g_pui8LinkTxBuf, g_pui8LinkRxBuf, LINK_BUF_SIZE, LINK_QUANTUM);
+        g_pfnPayloadHandler = PayloadToConsole;
+        g_bScanValid = false;
+        g_bScanOptions = false;
+        if (g_bSettings) {
+            SettingsErase();
+        }
+        memset(&g_sSettings, 0, sizeof(g_sSettings));
+        memset(&g_sSettingsNext, 0, sizeof(g_sSettingsNext));
+        UARTSend(UART0_BASE, (uint8_t *)"Factory settings restored. \r\n", strlen("Factory settings restored. \r\n"));
+        ModemBaudNegotiate(UIStart);
+        return;
+    }
 
-    //
-    // Get the interrupt status.
-    //
-    ui32Status = UARTIntStatus(UART5_BASE, true);
+    UIMenu();
+}
 
-    //
-    // Clear the asserted interrupts.
-    //
-    UARTIntClear(UART5_BASE, ui32Status);
+//*****************************************************************************
+//
+// Print the clock profile in use, who chose it, the switches made and the
+// time spent in each profile since start up.
+//
+//*****************************************************************************
+void
+UIClock(void)
+{
+    char text[96];
+    uint32_t ui32Index;
+
+    snprintf(text, sizeof(text), "Clock %s MHz, %s, %u switches\r\n",
+             g_psClockProfiles[g_sGovernor.ui32Current].pcName,
+             g_sGovernor.bAuto ? "auto" : "fixed",
+             (unsigned int)g_sGovernor.ui32Switches);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    for(ui32Index = 0; ui32Index < NUM_CLOCK_PROFILES; ui32Index++) {
+        snprintf(text, sizeof(text), "  %s MHz %10u ms\r\n",
+                 g_psClockProfiles[ui32Index].pcName,
+                 (unsigned int)(GovernorResidency(&g_sGovernor, ui32Index) / 1000));
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    }
+}
 
-    while(UARTCharsAvail(UART5_BASE))
-    {
-        char k = UARTCharGetNonBlocking(UART5_BASE);
+//*****************************************************************************
+//
+// Print the cycle count profiles gathered since they were last shown, then
+// start them again.  The time one byte takes to arrive at the ESP8266 baud
+// rate is the budget the receive path has to stay within.
+//
+//*****************************************************************************
+tProfile * const g_ppsProfiles[] =
+{
+    &g_sModemProfile,
+    &g_sUART0Profile,
+    &g_sSysTickProfile,
+    &g_sButton0Profile,
+    &g_sCoalesceTimerProfile,
+    &g_sGuardTimerProfile,
+    &g_sRGBBlinkProfile,
+    &g_sRGBColorSetProfile,
+    &g_sModemPollProfile,
+    &g_sConsoleProfile,
+};
+
+#define NUM_PROFILES            (sizeof(g_ppsProfiles) / sizeof(g_ppsProfiles[0]))
 
-        if(listing_networks == 0 && without_echo == 0) {
-            command[command_size++] = k;
-            UARTCharPutNonBlocking(UART0_BASE, k);
+void
+UIProfile(void)
+{
+    char text[96];
+    tProfile sProfile;
+    uint32_t ui32Index;
+
+    snprintf(text, sizeof(text), "Cycles at %u MHz, probe overhead %u removed, byte time %u at %u baud\r\n",
+             (unsigned int)(SysCtlClockGet() / 1000000),
+             (unsigned int)ProfileOverhead(),
+             (unsigned int)((SysCtlClockGet() * 10) / g_ui32ModemBaud),
+             (unsigned int)g_ui32ModemBaud);
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    snprintf(text, sizeof(text), "%-24s %8s %8s %8s %8s\r\n", "", "calls", "min", "mean", "max");
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    for(ui32Index = 0; ui32Index < NUM_PROFILES; ui32Index++) {
+        ProfileTake(g_ppsProfiles[ui32Index], &sProfile);
+
+        if (sProfile.ui32Count == 0) {
+            snprintf(text, sizeof(text), "%-24s %8u %8s %8s %8s\r\n", sProfile.pcName, 0, "-", "-", "-");
+        } else {
+            snprintf(text, sizeof(text), "%-24s %8u %8u %8u %8u\r\n", sProfile.pcName,
+                     (unsigned int)sProfile.ui32Count,
+                     (unsigned int)sProfile.ui32Min,
+                     (unsigned int)(sProfile.ui64Total / sProfile.ui32Count),
+                     (unsigned int)sProfile.ui32Max);
         }
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    }
 
-        if (strstr(command,"AT+CWLAP\x0d") && listing_networks == 0) {
-            listing_networks = 1;
-            without_echo = 1;
-            num_ssid = 0;
-            UARTCharPutNonBlocking(UART0_BASE, '\r');
-            UARTCharPutNonBlocking(UART0_BASE, '\n');
-        } else if (listing_networks == 1) {
-            if(k =='\x0d') {
-                if (strstr(ssid_entry[num_ssid],"OK")) {
-                    listing_networks = 0;
-                    without_echo = 0;
-                    command_size = 0;
-                    memset(command, 0, strlen(command));
-                    command_finished = 1;
-                } else {
-                    ssid_size = 0;
-                    num_ssid++;
-                }
-            } else if(k =='\x0a') {
-                continue;
-            } else {
-                ssid_entry[num_ssid][ssid_size++] = k;
+    UIClock();
+}
+
+//*****************************************************************************
+//
+// Print the round trip times of the AT commands since start up, in
+// milliseconds.  The percentiles are read from the histogram bins and may
+// be up to a quarter high; the maximum is exact.
+//
+//*****************************************************************************
+void
+UILatencyFormat(char *pcBuf, uint32_t ui32Us)
+{
+    snprintf(pcBuf, 12, "%u.%u", (unsigned int)(ui32Us / 1000), (unsigned int)((ui32Us % 1000) / 100));
+}
+
+void
+UILatency(void)
+{
+    char text[96];
+    char p50[12], p90[12], p99[12], max[12];
+    tHistogram *psHistogram;
+    uint32_t ui32Index;
+
+    snprintf(text, sizeof(text), "%-9s %6s %6s %9s %9s %9s %9s ms\r\n", "", "count", "failed", "p50", "p90", "p99", "max");
+    UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+
+    for(ui32Index = 0; ui32Index < NUM_MODEM_LATENCY; ui32Index++) {
+        psHistogram = &g_psModemLatency[ui32Index].sHistogram;
+
+        if (psHistogram->ui32Count == 0) {
+            continue;
+        }
+
+        UILatencyFormat(p50, HistogramPercentile(psHistogram, 500));
+        UILatencyFormat(p90, HistogramPercentile(psHistogram, 900));
+        UILatencyFormat(p99, HistogramPercentile(psHistogram, 990));
+        UILatencyFormat(max, psHistogram->ui32Max);
+
+        snprintf(text, sizeof(text), "%-9s %6u %6u %9s %9s %9s %9s\r\n", g_psModemLatency[ui32Index].pcName,
+                 (unsigned int)psHistogram->ui32Count,
+                 (unsigned int)g_psModemLatency[ui32Index].ui32Failed,
+                 p50, p90, p99, max);
+        UARTSend(UART0_BASE, (uint8_t *)text, strlen(text));
+    }
+}
+
+//*****************************************************************************
+//
+// Act on a menu choice.
+//
+//*****************************************************************************
+void
+UIMenuChoice(uint8_t choice)
+{
+    ConsolePutChar(choice);
+    UARTSend(UART0_BASE, (uint8_t *)"\r\n", strlen("\r\n"));
+
+    switch(choice)
+    {
+    case '1':
+        g_ui32UIState = UI_BUSY;
+        UICommand("AT+CWMODE=3\r\n", strlen("AT+CWMODE=3\r\n"), UIMenuDone);
+        break;
+    case '2':
+        if (g_bScanValid && (ClockMs() - g_ui32ScanTime) < SCAN_TTL_MS) {
+            UIScanList();
+            break;
+        }
+        UIScan();
+        break;
+    case '3':
+        if (g_bMux) {
+            g_ui32Link = LinkMuxFree(&g_sLinks);
+            if (g_ui32Link == LINK_MUX_NONE) {
+                g_ui32Link = 0;
+                UARTSend(UART0_BASE, (uint8_t *)"All links are in use. \r\n", strlen("All links are in use. \r\n"));
+                UIMenu();
+                break;
             }
         }
 
-        if (strstr(command,"AT+CWJAP=")){
-            without_echo = 1;
+        UARTSend(UART0_BASE, (uint8_t *)"First run server.py file. \n\r Type the number of port you'd like to use. \n\r", strlen("First run server.py file. \n\r Type the number of port you'd like to use. \n\r"));
+        g_ui32UIState = UI_PORT;
+        break;
+    case '4':
+        UARTSend(UART0_BASE, (uint8_t *)"Entered passthrough mode. \r\nWrite your messages. \r\n ++pin to send LED0 pin value. \n\r ++coalesce <ms> to pack messages, 0 to stop. \n\r ++flush to send packed messages. \n\r ++stats to show packing counters. \n\r ++link <n> to choose the connection. \n\r ++clock [auto|16|40|80] to choose the clock. \n\r +++ to exit. \n\r",
+                                 strlen("Entered passthrough mode. \r\nWrite your messages. \r\n ++pin to send LED0 pin value. \n\r ++coalesce <ms> to pack messages, 0 to stop. \n\r ++flush to send packed messages. \n\r ++stats to show packing counters. \n\r ++link <n> to choose the connection. \n\r ++clock [auto|16|40|80] to choose the clock. \n\r +++ to exit. \n\r"));
+        g_ui32UIState = UI_PASSTHROUGH;
+        break;
+    case '5':
+        g_ui32UIState = UI_BUSY;
+        if (!ModemRestart("AT+RESTORE\r\n", UIRestoreDone)) {
+            UIRefused();
+        }
+        break;
+    case '6':
+        TransparentMode();
+        break;
+    case '7':
+        g_ui32UIState = UI_BUSY;
+        if (!LinksMuxSet(!g_bMux, UIMuxDone)) {
+            UIRefused();
+        }
+        break;
+    case '8':
+        UIProfile();
+        UIMenu();
+        break;
+    case '9':
+        UILatency();
+        UIMenu();
+        break;
+    default:
+        UIMenu();
+        break;
+    }
+}
+
+//*****************************************************************************
+//
+// Act on a passthrough line.  Returns false if it has to be offered again
+// once the module is free.
+//
+//*****************************************************************************
+bool
+UIPassthroughLine(char *message)
+{
+    uint8_t *pui8Data;
+    uint32_t i;
+
+    if (strcmp(message, "+++") == 0) {
+        if (CoalescePending(&g_sCoalesce, &pui8Data)) {
+            PassthroughFlush(COALESCE_FLUSH_MARKER);
+            return(false);
+        }
+        UIMenu();
+        return(true);
+    }
+
+    if (strcmp(message, "++flush") == 0) {
+        PassthroughFlush(COALESCE_FLUSH_MARKER);
+        return(true);
+    }
+
+    if (strcmp(message, "++stats") == 0) {
+        PassthroughStats();
+        return(true);
+    }
+
+    if (strncmp(message, "++coalesce", 10) == 0) {
+        if (CoalescePending(&g_sCoalesce, &pui8Data)) {
+            PassthroughFlush(COALESCE_FLUSH_MARKER);
+            return(false);
         }
+        g_ui32CoalesceMs = (message[10] == '\0') ? COALESCE_DEFAULT_MS : atoi(message + 10);
+        return(true);
+    }
 
-        if(k =='\x0d') {
-            if (strstr(command, "OK") || strstr(command, "ERROR") && passthrough_mode == 0) {
-               command_finished = 1;
+    //
+    // "++clock" alone shows the clock, "++clock auto" hands it back to the
+    // governor and "++clock <MHz>" fixes it.
+    //
+    if (strncmp(message, "++clock", 7) == 0) {
+        if (strcmp(message + 7, " auto") == 0) {
+            GovernorAuto(&g_sGovernor);
+        } else if (message[7] == ' ') {
+            for (i = 0; i < NUM_CLOCK_PROFILES; i++) {
+                if (strcmp(message + 8, g_psClockProfiles[i].pcName) == 0) {
+                    GovernorSet(&g_sGovernor, i);
+                    break;
+                }
             }
-            without_echo = 0;
-            command_size = 0;
-            memset(command, 0, strlen(command));
+            if (i == NUM_CLOCK_PROFILES) {
+                UARTSend(UART0_BASE, (uint8_t *)"No such clock. \r\n", strlen("No such clock. \r\n"));
+            }
+        }
+        UIClock();
+        return(true);
+    }
+
+    if (strncmp(message, "++link", 6) == 0) {
+        g_ui32Link = atoi(message + 6);
+        if (!LinkMuxIsOpen(&g_sLinks, g_ui32Link)) {
+            UARTSend(UART0_BASE, (uint8_t *)"Link is not open. \r\n", strlen("Link is not open. \r\n"));
         }
+        return(true);
+    }
+
+    //
+    // The pin value replaces the line, so a retry sends the same value.
+    //
+    if (strcmp(message, "++pin") == 0) {
+        int val = GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_3);
+        if (val) val = 1;
+        snprintf(message, 128, "%d", val);
     }
+
+    return(PassthroughSend((uint8_t *)message, strlen(message)));
 }
 
 //*****************************************************************************
 //
-// The Button0 interrupt handler.
+// Act on a line typed in the current state.  Returns false if it has to be
+// offered again once the module is free.
 //
 //*****************************************************************************
-void
-Button0IntHandler(void)
+bool
+UILine(char *line)
 {
-    uint32_t status = 0;
+    char text[AT_QUEUE_CMD_SIZE];
+    int length;
 
-    status = GPIOIntStatus(BUTTONS_GPIO_BASE, true);
-    GPIOIntClear(BUTTONS_GPIO_BASE, status);
+    switch(g_ui32UIState)
+    {
+    case UI_SSID:
+        if (line[0] == 'r' && line[1] == '\0') {
+            UIScan();
+            break;
+        }
 
-    if (status & GPIO_INT_PIN_4){
-        uint8_t  value = GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_3);
+        chosen_network = atoi(line) - 1;
+        if (chosen_network < 0 || chosen_network >= ScanListCount(&g_sScanList)) {
+            UIMenu();
+            break;
+        }
 
-        if (value == 0)
-          GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, GPIO_PIN_3);
+        UARTSend(UART0_BASE, (uint8_t *) ScanListGet(&g_sScanList, chosen_network)->pcSSID, strlen(ScanListGet(&g_sScanList, chosen_network)->pcSSID));
+        UARTSend(UART0_BASE, (uint8_t *)"\n\r", strlen("\n\r"));
+
+        strncpy(g_sSettingsNext.pcSSID, ScanListGet(&g_sScanList, chosen_network)->pcSSID, sizeof(g_sSettingsNext.pcSSID));
+        memcpy(g_sSettingsNext.pui8BSSID, ScanListGet(&g_sScanList, chosen_network)->pui8BSSID, sizeof(g_sSettingsNext.pui8BSSID));
+        g_sSettingsNext.ui8Channel = ScanListGet(&g_sScanList, chosen_network)->ui8Channel;
+
+        UARTSend(UART0_BASE, (uint8_t *)"Password: \n\r", strlen("Password: \n\r"));
+        g_ui32UIState = UI_PASSWORD;
+        break;
+    case UI_PASSWORD:
+        length = snprintf(text, sizeof(text), "AT+CWJAP=\"%s\",\"%s\"\r\n", ScanListGet(&g_sScanList, chosen_network)->pcSSID, line);
+        strncpy(g_sSettingsNext.pcPassword, line, sizeof(g_sSettingsNext.pcPassword) - 1);
+        g_sSettingsNext.pcPassword[sizeof(g_sSettingsNext.pcPassword) - 1] = '\0';
+
+        g_ui32UIState = UI_BUSY;
+        UICommand(text, length, UIJoinDone);
+        break;
+    case UI_PORT:
+        port_number = atoi(line);
+
+        UARTSend(UART0_BASE, (uint8_t *)"Enter IP address you'd like to message. \n\r", strlen("Enter IP address you'd like to message. \n\r"));
+        g_ui32UIState = UI_IP;
+        break;
+    case UI_IP:
+        strncpy(g_sSettingsNext.pcHost, line, sizeof(g_sSettingsNext.pcHost) - 1);
+        g_sSettingsNext.pcHost[sizeof(g_sSettingsNext.pcHost) - 1] = '\0';
+        g_sSettingsNext.ui16Port = port_number;
+
+        if (g_bMux)
+            length = snprintf(text, sizeof(text), "AT+CIPSTART=%u,\"TCP\",\"%s\",%d\r\n", (unsigned int)g_ui32Link, line, port_number);
         else
-          GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, 0);
+            length = snprintf(text, sizeof(text), "AT+CIPSTART=\"TCP\",\"%s\",%d\r\n", line, port_number);
+
+        g_ui32UIState = UI_BUSY;
+        UICommand(text, length, UIConnectDone);
+        break;
+    case UI_PASSTHROUGH:
+        return(UIPassthroughLine(line));
+    default:
+        break;
     }
+
+    return(true);
 }
 
 //*****************************************************************************
 //
-// Send a string to the UART.  This function sends a string of characters to a
-// particular UART module.
+// Take console input for the current state.  Input is taken while the
+// command queue has room for what a line can start, at most UI_COMMANDS_MAX
+// commands (a scan queues AT+CWMODE, AT+CWLAPOPT and AT+CWLAP), so typing
+// goes on while the module works; a line that cannot be sent yet is offered
+// again later.  Lines are echoed as they are typed, the password as stars;
+// empty lines are ignored.
 //
 //*****************************************************************************
+#define UI_COMMANDS_MAX         3
+
+char console_line[LINE_SIZE];
+uint32_t console_length = 0;
+bool console_line_ready = false;
+
 void
-UARTSend(uint32_t ui32UARTBase, const uint8_t *pui8Buffer, uint32_t ui32Count)
+ConsoleService(void)
 {
-    //
-    // Loop while there are more characters to send.
-    //
-    while(ui32Count--)
+    uint8_t k;
+
+    while(ATQueueDepth(&g_sATQueue) + UI_COMMANDS_MAX <= AT_QUEUE_DEPTH)
     {
-        //
-        // Write the next character to the UART.
-        //
-        UARTCharPut(ui32UARTBase, *pui8Buffer++);
+        if(g_ui32UIState == UI_TRANSPARENT) {
+            TransparentInput();
+            return;
+        }
+
+        if(g_ui32UIState == UI_BUSY || g_ui32UIState == UI_TRANSPARENT_EXIT) {
+            return;
+        }
+
+        if(console_line_ready) {
+            if(!UILine(console_line)) {
+                return;
+            }
+            console_line_ready = false;
+            console_length = 0;
+            continue;
+        }
+
+        if(!RingBufGet(&g_sUART0RxRing, &k)) {
+            return;
+        }
+
+        if(k == '\n' || k == '\r') {
+            if(console_length) {
+                UARTSend(UART0_BASE, (uint8_t *)"\r\n", 2);
+                console_line[console_length] = '\0';
+                console_line_ready = true;
+            }
+            continue;
+        }
+
+        if(g_ui32UIState == UI_MENU) {
+            UIMenuChoice(k);
+            continue;
+        }
+
+        if(console_length < LINE_SIZE - 1) {
+            console_line[console_length++] = k;
+            ConsolePutChar(g_ui32UIState == UI_PASSWORD ? '*' : k);
+        }
     }
 }
 
@@ -250,8 +2502,16 @@ UARTSend(uint32_t ui32UARTBase, const uint8_t *pui8Buffer, uint32_t ui32Count)
 int
 main(void)
 {
-    SysCtlClockSet(SYSCTL_SYSDIV_1 | SYSCTL_USE_OSC | SYSCTL_OSC_MAIN |
-                       SYSCTL_XTAL_16MHZ);
+    uint32_t ui32Start;
+    uint32_t ui32Index;
+    uint32_t ui32Event;
+
+    //
+    // Start at full speed.  The governor lowers the clock once the board has
+    // been idle for a while.
+    //
+    GovernorInit(&g_sGovernor, g_psClockProfiles, NUM_CLOCK_PROFILES,
+                 CLOCK_LOW, CLOCK_HIGH, CLOCK_IDLE_MS, ClockApply);
 
     //
     // Enable the peripherals used by this example.
@@ -260,10 +2520,33 @@ main(void)
     //          received at the Rx.
     //
     SysCtlPeripheralEnable(SYSCTL_PERIPH_UART0);
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_UART5);
+    SysCtlPeripheralEnable(MODEM_UART_PERIPH);
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
+#ifdef MODEM_UART1
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOC);
+#endif
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER2);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_WTIMER5);
+
+    ProfileInit();
+    EventQueueInit(&g_sEvents);
+    for(ui32Index = 0; ui32Index < NUM_MODEM_LATENCY; ui32Index++)
+    {
+        HistogramClear(&g_psModemLatency[ui32Index].sHistogram);
+    }
+    RingBufInit(&g_sModemRxRing, g_pui8ModemRxBuf, sizeof(g_pui8ModemRxBuf));
+    RingBufInit(&g_sModemTxRing, g_pui8ModemTxBuf, sizeof(g_pui8ModemTxBuf));
+    RingBufInit(&g_sUART0RxRing, g_pui8UART0RxBuf, sizeof(g_pui8UART0RxBuf));
+    RingBufInit(&g_sUART0TxRing, g_pui8UART0TxBuf, sizeof(g_pui8UART0TxBuf));
+    ATParserInit(&g_sATParser);
+    ATQueueInit(&g_sATQueue, ModemWrite, ClockUs);
+    ATQueueTimingSet(&g_sATQueue, ModemTiming);
+    CoalesceInit(&g_sCoalesce, g_pui8CoalesceBuf, sizeof(g_pui8CoalesceBuf));
+    LinkMuxInit(&g_sLinks, g_pui8LinkTxBuf, g_pui8LinkRxBuf, LINK_BUF_SIZE, LINK_QUANTUM);
 
     //
     // Enable processor interrupts.
@@ -277,15 +2560,21 @@ main(void)
     GPIOPinConfigure(GPIO_PA1_U0TX);
     GPIOPinTypeUART(GPIO_PORTA_BASE, GPIO_PIN_0 | GPIO_PIN_1);
 
+#ifdef MODEM_UART1
+    GPIOPinConfigure(GPIO_PB0_U1RX);
+    GPIOPinConfigure(GPIO_PB1_U1TX);
+    GPIOPinTypeUART(GPIO_PORTB_BASE, GPIO_PIN_0 | GPIO_PIN_1);
+    GPIOPinConfigure(GPIO_PC4_U1RTS);
+    GPIOPinConfigure(GPIO_PC5_U1CTS);
+    GPIOPinTypeUART(GPIO_PORTC_BASE, GPIO_PIN_4 | GPIO_PIN_5);
+#else
     GPIOPinConfigure(GPIO_PE4_U5RX);
     GPIOPinConfigure(GPIO_PE5_U5TX);
     GPIOPinTypeUART(GPIO_PORTE_BASE, GPIO_PIN_4 | GPIO_PIN_5);
+#endif
 
     GPIOPinTypeGPIOOutput(GPIO_PORTE_BASE, GPIO_PIN_1);
 
-    IntEnable(INT_UART5);
-    UARTIntEnable(UART5_BASE, UART_INT_RX | UART_INT_RT);
-
     //
     // Enable the GPIO pin for the LED (PF3).  Set the direction as output, and
     // enable the GPIO pin for digital function.
@@ -302,17 +2591,55 @@ main(void)
     GPIOIntEnable(GPIO_PORTF_BASE, LEFT_BUTTON);
 
     //
-    // Configure the UART for 115,200, 8-N-1 operation.
+    // Configure the UARTs for 8-N-1 operation, clocked from the PIOSC so
+    // that the governor can change the system clock.  The ESP8266 starts at
+    // MODEM_BAUD; the rate is negotiated once the main loop runs.
     //
-
-    UARTConfigSetExpClk(UART0_BASE, SysCtlClockGet(), 115200,
+    UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
+    UARTClockSourceSet(MODEM_UART_BASE, UART_CLOCK_PIOSC);
+    UARTConfigSetExpClk(UART0_BASE, UART_CLOCK_HZ, CONSOLE_BAUD,
                             (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
                              UART_CONFIG_PAR_NONE));
-    UARTConfigSetExpClk(UART5_BASE, SysCtlClockGet(), 115200,
+    UARTConfigSetExpClk(MODEM_UART_BASE, UART_CLOCK_HZ, MODEM_BAUD,
                             (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
                              UART_CONFIG_PAR_NONE));
+#ifdef MODEM_UART1
+    UARTFlowControlSet(MODEM_UART_BASE, UART_FLOWCONTROL_TX | UART_FLOWCONTROL_RX);
+#endif
     GPIOPinWrite(GPIO_PORTE_BASE, GPIO_PIN_1, GPIO_PIN_1);
 
+    //
+    // Hand both transmitters and the ESP8266 receiver over to the uDMA
+    // controller.  Console input is taken by the UART0 interrupt handler.
+    //
+    UARTDMAInit();
+    UARTDMATxInit(UART0_BASE, &g_sUART0TxRing);
+    UARTDMATxInit(MODEM_UART_BASE, &g_sModemTxRing);
+    UARTDMARxInit(MODEM_UART_BASE, &g_sModemRxRing);
+    UARTIntEnable(MODEM_UART_BASE, UART_INT_OE | UART_INT_BE | UART_INT_FE);
+    UARTIntEnable(UART0_BASE, UART_INT_RX | UART_INT_RT | UART_INT_OE);
+    IntEnable(INT_UART0);
+
+    //
+    // Timer 2A times the coalescing flush, one shot per batch.
+    //
+    TimerConfigure(TIMER2_BASE, TIMER_CFG_ONE_SHOT);
+    TimerIntEnable(TIMER2_BASE, TIMER_TIMA_TIMEOUT);
+    IntEnable(INT_TIMER2A);
+
+    //
+    // Wide Timer 5A times the transparent mode escape guard.
+    //
+    TimerConfigure(WTIMER5_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_ONE_SHOT);
+    TimerIntEnable(WTIMER5_BASE, TIMER_TIMA_TIMEOUT);
+    IntEnable(INT_WTIMER5A);
+
+    //
+    // SysTick keeps the clock and collects ESP8266 data the receive timeout
+    // leaves behind.
+    //
+    ClockInit(SysCtlClockGet(), SYSTICK_HZ);
+
     //
     // Turn on LED
     //
@@ -321,198 +2648,65 @@ main(void)
     UARTSend(UART0_BASE, (uint8_t *)"\033[2J\033[1;1H", 10);
 
     //
-    // Loop forever echoing data through the UART.
+    // Raise the ESP8266 link rate, then rejoin the network saved in EEPROM,
+    // if there is one.
+    //
+    g_bSettings = SettingsInit();
+    if (g_bSettings) {
+        SettingsLoad(&g_sSettings);
+    }
+    g_ui32UIState = UI_BUSY;
+    ModemBaudNegotiate(UIStart);
+
+    //
+    // Run each event to completion, then bring the module, the console and
+    // the links up to date.  EventWait() sleeps until an interrupt posts
+    // the next event.
     //
     while(1)
     {
-        UARTSend(UART0_BASE, (uint8_t *)"Command List:\r\n 1. Set mode \r\n 2. Connect to WiFi \r\n 3. Choose port for communication \r\n 4. Enter passthrough mode \r\n 5. Restore Factory Default Settings\r\n",
-                        strlen("Command List:\r\n 1. Set mode \r\n 2. Connect to WiFi \r\n 3. Choose port for communication \r\n 4. Enter passthrough mode \r\n 5. Restore Factory Default Settings\r\n"));
-
-        uint8_t choice = UARTCharGet(UART0_BASE);
-
-        UARTCharPut(UART0_BASE, choice);
-        UARTSend(UART0_BASE, "\r\n", strlen("\r\n"));
+        ui32Event = EventWait(&g_sEvents);
+        if(ui32Event == EVENT_CLOCK) {
+            GovernorIdle(&g_sGovernor);
+            continue;
+        }
+        GovernorActivity(&g_sGovernor);
 
-        switch(choice)
+        switch(ui32Event)
         {
-        case '1':
-            UARTSend(UART5_BASE, (uint8_t *)"AT+CWMODE=3\r\n", strlen("AT+CWMODE=3\r\n"));
-
-            while(command_finished == 0) {
-            }
-
-            command_finished = 0;
+        case EVENT_BUTTON:
+            ButtonPressed();
             break;
-        case '2':
-            UARTSend(UART5_BASE, (uint8_t *)"AT+CWLAP\r\n", strlen("AT+CWLAP\r\n"));
-
-            while(command_finished == 0) {
-            }
-
-            command_finished = 0;
-            char listed_number[4];
-            char delimiter_comma[2] = ",";
-            char delimiter_quote[2] = "\"";
-            int i;
-
-            for(i = 0; i < num_ssid-1; i++) {
-                snprintf(listed_number, 4, "%d. ", i+1);
-                char* token;
-                char* ssid;
-
-                token = strtok(ssid_entry[i], delimiter_comma);
-                token = strtok(NULL, delimiter_comma);
-                ssid = strtok(token, delimiter_quote);
-
-                UARTSend(UART0_BASE, (uint8_t *)listed_number, strlen(listed_number));
-                UARTSend(UART0_BASE, (uint8_t *)ssid, strlen(ssid));
-                UARTSend(UART0_BASE, (uint8_t *)"\n\r", strlen("\n\r"));
-                put(ssid, i);
-            }
-
-            UARTSend(UART0_BASE, (uint8_t *)"Choose network: \n\r Type 0 to exit \n\r", strlen("Choose network: \n\r Type 0 to exit \n\r"));
-
-            char choice2_char[4] = "";
-            i = 0;
-
-            while(1) {
-                 char k = UARTCharGet(UART0_BASE);
-                 UARTCharPut(UART0_BASE, k);
-                 if(k == '\n' || k == '\r') break;
-                 choice2_char[i++] = k;
-            }
-
-            UARTSend(UART0_BASE, "\r\n", strlen("\r\n"));
-
-            int choice2 = atoi(choice2_char) - 1;
-            if (choice2 < 0 || choice2 >= num_ssid)
-                continue;
-
-            UARTSend(UART0_BASE, (uint8_t *) ssid_list[choice2], strlen(ssid_list[choice2]));
-            UARTSend(UART0_BASE, (uint8_t *)"\n\r", strlen("\n\r"));
-
-            UARTSend(UART0_BASE, (uint8_t *)"Password: \n\r", strlen("Password: \n\r"));
-
-            char password[64];
-            i = 0;
-            password[i] = UARTCharGet(UART0_BASE);
-            UARTCharPut(UART0_BASE, '*');
-
-            while(1) {
-                 char k = UARTCharGet(UART0_BASE);
-                 UARTCharPut(UART0_BASE, '*');
-                 if(k == '\n' || k == '\r') break;
-                 password[++i] = k;
-            }
-            password[++i] = '\0';
-
-            UARTSend(UART0_BASE, "\r\n", strlen("\r\n"));
-
-            char text[128];
-            snprintf(text, 128, "AT+CWJAP=\"%s\",\"%s\"\r\n", ssid_list[choice2], password);
-
-            UARTSend(UART5_BASE, (uint8_t *)text, strlen(text));
-
-            while(command_finished == 0) {
+        case EVENT_GUARD:
+            if(g_bGuardExpired) {
+                TransparentGuard();
             }
-            command_finished = 0;
-
             break;
-        case '3':
-            UARTSend(UART0_BASE, (uint8_t *)"First run server.py file. \n\r Type the number of port you'd like to use. \n\r", strlen("First run server.py file. \n\r Type the number of port you'd like to use. \n\r"));
-
-            char port_number_char[5] = "";
-            i = 0;
-            port_number_char[i] = UARTCharGet(UART0_BASE);
-            UARTCharPut(UART0_BASE, port_number_char[i]);
-
-            while(1) {
-                 char k = UARTCharGet(UART0_BASE);
-                 UARTCharPut(UART0_BASE, k);
-                 if(k == '\n' || k == '\r') break;
-                 port_number_char[++i] = k;
-            }
-
-            UARTSend(UART0_BASE, "\r\n", strlen("\r\n"));
-
-            int port_number = atoi(port_number_char);
-
-            UARTSend(UART0_BASE, (uint8_t *)"Enter IP address you'd like to message. \n\r", strlen("Enter IP address you'd like to message. \n\r"));
-
-            char ip_address[16] = "";
-            i = 0;
-            ip_address[i] = UARTCharGet(UART0_BASE);
-            UARTCharPut(UART0_BASE, ip_address[i]);
-
-            while(1) {
-                 char k = UARTCharGet(UART0_BASE);
-                 UARTCharPut(UART0_BASE, k);
-                 if(k == '\n' || k == '\r') break;
-                 ip_address[++i] = k;
-            }
-            ip_address[++i] = '\0';
-            UARTSend(UART0_BASE, "\r\n", strlen("\r\n"));
-
-            snprintf(text, 128, "AT+CIPSTART=\"TCP\",\"%s\",%d\r\n", ip_address, port_number);
-            UARTSend(UART5_BASE, (uint8_t *)text, strlen(text));
-
-            while(command_finished == 0) {
-            }
-
-            command_finished = 0;
+        case EVENT_TIMEOUT:
+            ATQueueTick(&g_sATQueue);
             break;
-        case '4':
-            passthrough_mode = 1;
-            UARTSend(UART0_BASE, (uint8_t *)"Entered passthrough mode. \r\nWrite your messages. \r\n ++pin to send LED0 pin value. \n\r +++ to exit. \n\r",
-                                     strlen("Entered passthrough mode. \r\nWrite your messages. \r\n ++pin to send LED0 pin value. \n\r +++ to exit. \n\r"));
-
-            while(passthrough_mode == 1) {
-                char message [128] = "";
-                i = 0;
-                message[i] = UARTCharGet(UART0_BASE);
-                UARTCharPut(UART0_BASE, message[i]);
-
-                while(1) {
-                     char k = UARTCharGet(UART0_BASE);
-                     UARTCharPut(UART0_BASE, k);
-                     if(k == '\n' || k == '\r') break;
-                     message[++i] = k;
-                }
-                message[++i] = '\0';
-
-                if (strcmp(message, "+++") == 0) {
-                    passthrough_mode = 0;
-                    break;
-                }
-
-                if (strcmp(message, "++pin") == 0) {
-                    int val = GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_3);
-                    if (val) val = 1;
-                    memset(message, 0, val);
-                    snprintf(message, 128, "%d", val);
-                }
-
-                char text1[128];
-                snprintf(text1, 128, "AT+CIPSEND=%d\r\n", strlen(message));
-
-                UARTSend(UART5_BASE, (uint8_t *)text1, strlen(text1));
+        default:
+            break;
+        }
 
-                SysCtlDelay(1000 * (SysCtlClockGet() / 3 / 1000));
+        PROFILE_START(ui32Start);
+        ModemPoll();
+        PROFILE_END(&g_sModemPollProfile, ui32Start);
 
-                while(command_finished == 0) {
-                }
+        ModemBaudCheck();
 
-                command_finished = 0;
+        if(g_sCoalesce.bDue) {
+            PassthroughFlush(COALESCE_FLUSH_TIMER);
+        }
 
-                UARTSend(UART5_BASE, (uint8_t *)message, strlen(message));
-            }
+        PROFILE_START(ui32Start);
+        ConsoleService();
+        PROFILE_END(&g_sConsoleProfile, ui32Start);
 
-            break;
-        case '5':
-            UARTSend(UART5_BASE, (uint8_t *)"AT+RESTORE\r\n", strlen("AT+RESTORE\r\n"));
-            break;
-        default:
-            break;
+        if(g_bMux) {
+            LinksService();
         }
+
+        ModemDeadlineUpdate();
     }
 }
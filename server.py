@@ -1,27 +1,262 @@
+#!/usr/bin/env python3
+#
+# server.py - TCP server for the boards to talk to.
+#
+# Serves any number of boards at once.  What each board sends is printed
+# as it arrives, tagged with its connection number, and lines typed here go
+# to the board chosen, so one operator can talk to a whole fleet without
+# holding up what they send:
+#
+#   text        sends text to the chosen connection, or to all of them
+#   /to N       chooses connection N; /all chooses every connection
+#   /list       lists the connections
+#   /close N    closes connection N
+#
+# The port is the first argument, or asked for when there is none.
+#
+# For measurements the server can instead answer on its own with --mode:
+#
+#   echo        sends back whatever arrives
+#   reply       sends --text for each piece that arrives
+#   sink        reads and discards
+#   timed       sends --size bytes --delay ms after each piece arrives
+#
+# and reports each connection's receive rate and response gaps every
+# --report seconds and when it closes.  A response gap is the time from a
+# send to the first data that arrives after it.  It is a round trip only
+# when the far end answers every send, one for one, as a board echoing
+# what it receives would; against a board that sends on its own it only
+# says how soon something came in after each send:
+#
+#   server.py 5555 --mode echo --report 5
+#
+
+import argparse
+import asyncio
 import socket
-import signal
-import sys 
-
-serv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-serv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
-port = input('Choose a port you would like to use. ')
-serv.bind(('', int(port)))
-serv.listen(5)
-while True:
-	conn, addr = serv.accept()
-	from_client = ''
+import sys
+import time
+
+
+class Connection:
+    def __init__(self, number, reader, writer):
+        self.number = number
+        self.reader = reader
+        self.writer = writer
+        self.peer = "%s:%d" % writer.get_extra_info("peername")[:2]
+        self.received = 0
+        self.sent = 0
+        self.chunks = 0
+        self.start = time.monotonic()
+        self.first = None
+        self.last = None
+        self.waiting = None
+        self.gaps = []
+        self.replies = set()
+        self.seq = 0
+
+    def send(self, data):
+        # The writer buffers what the socket will not take yet, so a slow
+        # board never holds up the others or the operator.
+        self.sent += len(data)
+        self.writer.write(data)
+        if self.waiting is None:
+            self.waiting = time.monotonic()
+
+    def arrived(self, data):
+        now = time.monotonic()
+        self.received += len(data)
+        self.chunks += 1
+        if self.first is None:
+            self.first = now
+        self.last = now
+        if self.waiting is not None:
+            self.gaps.append(now - self.waiting)
+            self.waiting = None
+
+    def report(self):
+        span = (self.last - self.first) if self.chunks > 1 else 0
+        text = "%d bytes in %d pieces, %d out" % (self.received, self.chunks,
+                                                 self.sent)
+        if span:
+            text += ", %.1f bytes/s, %.1f pieces/s" % (
+                self.received / span, (self.chunks - 1) / span)
+        if self.gaps:
+            gaps = sorted(self.gaps)
+            text += ", response gap ms n %d min %.2f p50 %.2f p90 %.2f " \
+                    "p99 %.2f max %.2f" % (len(gaps), gaps[0] * 1000,
+                                           percentile(gaps, 0.50) * 1000,
+                                           percentile(gaps, 0.90) * 1000,
+                                           percentile(gaps, 0.99) * 1000,
+                                           gaps[-1] * 1000)
+        return text
+
+
+def percentile(values, fraction):
+    index = min(len(values) - 1, max(0, int(len(values) * fraction + 0.5) - 1))
+    return values[index]
+
+
+class Server:
+    def __init__(self, args):
+        self.args = args
+        self.connections = {}
+        self.next = 1
+        self.chosen = None
+
+    def log(self, text):
+        sys.stdout.write(text + "\n")
+        sys.stdout.flush()
+
+    async def serve(self, reader, writer):
+        sock = writer.get_extra_info("socket")
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+        conn = Connection(self.next, reader, writer)
+        self.next += 1
+        self.connections[conn.number] = conn
+        self.log("[%d] %s connected" % (conn.number, conn.peer))
+
+        mode = self.args.mode
+
+        try:
+            while True:
+                data = await reader.read(4096)
+                if not data:
+                    break
+                conn.arrived(data)
+                if mode == "echo":
+                    conn.send(data)
+                elif mode == "reply":
+                    conn.send(self.args.text.encode("latin-1"))
+                elif mode == "timed":
+                    reply = asyncio.ensure_future(self.timed(conn))
+                    conn.replies.add(reply)
+                    reply.add_done_callback(conn.replies.discard)
+                elif mode == "interactive":
+                    self.log("[%d] %s" % (conn.number, data.decode(
+                        "latin-1").rstrip("\r\n")))
+        except ConnectionError:
+            pass
+        finally:
+            for reply in list(conn.replies):
+                reply.cancel()
+            del self.connections[conn.number]
+            if self.chosen == conn.number:
+                self.chosen = None
+            writer.close()
+            self.log("[%d] %s disconnected, %s" %
+                     (conn.number, conn.peer, conn.report()))
+
+    async def timed(self, conn):
+        # A numbered message padded to the size, so the far end can tell
+        # them apart.
+        await asyncio.sleep(self.args.delay / 1000.0)
+        header = "#%d:" % conn.seq
+        conn.seq += 1
+        conn.send((header + "." * max(0, self.args.size - len(header)))
+                  .encode("latin-1"))
+
+    async def reporter(self):
+        while True:
+            await asyncio.sleep(self.args.report)
+            for conn in list(self.connections.values()):
+                self.log("[%d] %s" % (conn.number, conn.report()))
+
+    def targets(self):
+        if self.chosen is None:
+            return list(self.connections.values())
+        return [self.connections[self.chosen]]
+
+    def command(self, line):
+        words = line.split() or [""]
+        if words[0] == "/list":
+            for conn in self.connections.values():
+                self.log("[%d] %s, %s%s" %
+                         (conn.number, conn.peer, conn.report(),
+                          " (chosen)" if conn.number == self.chosen else ""))
+            if not self.connections:
+                self.log("no connections")
+        elif words[0] == "/all":
+            self.chosen = None
+        elif words[0] in ("/to", "/close") and len(words) == 2 and \
+                words[1].isdigit() and int(words[1]) in self.connections:
+            if words[0] == "/to":
+                self.chosen = int(words[1])
+            else:
+                self.connections[int(words[1])].writer.close()
+        else:
+            self.log("commands: /to N, /all, /list, /close N")
+
+    async def operator(self):
+        loop = asyncio.get_running_loop()
+        reader = asyncio.StreamReader()
+        try:
+            await loop.connect_read_pipe(
+                lambda: asyncio.StreamReaderProtocol(reader), sys.stdin)
+        except ValueError:
+            # A regular file cannot be waited on; serve without an operator.
+            return
+
         while True:
-            data = conn.recv(4096)
-            if not data: break
-            from_client = data
-            print from_client
-            from_server = raw_input('Type your message\n')
-            conn.send(from_server)
-        conn.close()
-        print 'client disconnected'
-
-def sigint_handler(signal, frame):
-    print 'Interrupted'
-    conn.close()
-    sys.exit(0)
-signal.signal(signal.SIGINT, sigint_handler)
+            line = await reader.readline()
+            if not line:
+                return
+            line = line.decode("latin-1").rstrip("\r\n")
+            if line.startswith("/"):
+                self.command(line)
+                continue
+
+            targets = self.targets()
+            if not targets:
+                self.log("no connection to send to")
+            for conn in targets:
+                conn.send(line.encode("latin-1"))
+
+
+async def run(args):
+    server = Server(args)
+    listener = await asyncio.start_server(server.serve, None, args.port,
+                                          reuse_address=True)
+    server.log("listening on port %d, %s mode" % (args.port, args.mode))
+    if args.report:
+        asyncio.ensure_future(server.reporter())
+    async with listener:
+        if args.mode == "interactive":
+            await server.operator()
+
+        # Go on serving once the operator's input has ended.
+        await listener.serve_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="TCP server for the boards to talk to.")
+    parser.add_argument("port", type=int, nargs="?")
+    parser.add_argument("--mode", default="interactive",
+                        choices=["interactive", "echo", "reply", "sink",
+                                 "timed"],
+                        help="how to answer (default interactive)")
+    parser.add_argument("--text", default="ok\n",
+                        help="what reply mode sends (default ok and a "
+                             "newline)")
+    parser.add_argument("--size", type=int, default=32,
+                        help="bytes timed mode replies with (default 32)")
+    parser.add_argument("--delay", type=float, default=100,
+                        help="ms from each piece that arrives to timed "
+                             "mode's reply (default 100)")
+    parser.add_argument("--report", type=float, default=0, metavar="S",
+                        help="report every connection every S seconds")
+    args = parser.parse_args()
+
+    if args.port is None:
+        args.port = int(input("Choose a port you would like to use. "))
+
+    try:
+        asyncio.run(run(args))
+    except KeyboardInterrupt:
+        print("Interrupted")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,433 @@
+#!/usr/bin/env python3
+#
+# bench.py - End-to-end throughput and latency benchmark, console to server.
+#
+# Types timestamped messages into the firmware's console, through the
+# passthrough menu or transparent mode, and receives them on a TCP sink of
+# its own, so the whole path console -> firmware -> ESP8266 -> TCP is timed
+# by one clock.  Each message starts with a header "#<seq>:<us>:" and is
+# padded with dots to the message size; the sink finds the headers in the
+# stream whatever the firmware packs together.
+#
+# By default the host build runs against the simulator:
+#
+#   make -C host
+#   tools/bench.py --path passthrough --size 16,64,120 --rate 20,50 --count 200
+#
+# With a real board, give its console and an address the module can reach;
+# the board must already have joined the network:
+#
+#   tools/bench.py --console /dev/ttyACM0 --listen 0.0.0.0 --server-ip 192.168.1.10
+#
+# Every run prints one JSON object per line (or a CSV row with --csv):
+# what was sent, what arrived, bytes/s and messages/s over the time from the
+# first send to the last arrival, and one-way latency percentiles in
+# microseconds.  The firmware revision is recorded so runs can be compared.
+#
+
+import argparse
+import bisect
+import json
+import os
+import re
+import socket
+import subprocess
+import sys
+import termios
+import threading
+import time
+import tty
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(HERE)
+
+HEADER = re.compile(rb"#(\d+):(\d+):")
+
+# The ++stats line with the console input the firmware had no room for.
+DROPPED = re.compile(rb"console dropped (\d+), overruns (\d+)")
+
+FIELDS = ["revision", "path", "size", "rate", "coalesce", "sent",
+          "delivered", "lost", "fw_dropped", "sent_bytes", "received_bytes",
+          "duration_s", "bytes_per_s", "msgs_per_s",
+          "lat_min_us", "lat_p50_us", "lat_p90_us", "lat_p99_us",
+          "lat_max_us", "lat_mean_us"]
+
+
+def now_us():
+    return time.monotonic_ns() // 1000
+
+
+def revision():
+    try:
+        return subprocess.run(["git", "-C", ROOT, "describe", "--always",
+                               "--dirty"], capture_output=True, text=True,
+                              check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+class Sink:
+    """TCP server that timestamps each message header as it arrives."""
+
+    def __init__(self, address):
+        self.server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.server.bind((address, 0))
+        self.server.listen(1)
+        self.port = self.server.getsockname()[1]
+        self.arrivals = {}
+        self.start = None
+        self.received = 0
+        self.last = 0
+        self.lock = threading.Lock()
+        threading.Thread(target=self.accept, daemon=True).start()
+
+    def accept(self):
+        while True:
+            try:
+                conn, _ = self.server.accept()
+            except OSError:
+                return
+            conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            threading.Thread(target=self.receive, args=(conn,),
+                             daemon=True).start()
+
+    def receive(self, conn):
+        # Stamp each chunk, so a header split across two is given the time
+        # its last byte came in.
+        data = bytearray()
+        ends = []
+        stamps = []
+        base = 0
+        while True:
+            try:
+                chunk = conn.recv(65536)
+            except OSError:
+                break
+            if not chunk:
+                break
+            stamp = now_us()
+            data += chunk
+            ends.append(base + len(data))
+            stamps.append(stamp)
+
+            parsed = 0
+            with self.lock:
+                self.received += len(chunk)
+                self.last = stamp
+                for match in HEADER.finditer(data):
+                    at = bisect.bisect_left(ends, base + match.end())
+                    seq = int(match.group(1))
+                    sent = int(match.group(2))
+                    parsed = match.end()
+
+                    # A message the firmware cut short can run into the
+                    # next one and make a header of the wrong time.
+                    if self.start is None or not \
+                       self.start <= sent <= stamps[at]:
+                        continue
+                    if seq not in self.arrivals:
+                        self.arrivals[seq] = (sent, stamps[at])
+
+            # Keep what may be the start of a header.
+            keep = max(parsed, len(data) - 32)
+            del data[:keep]
+            base += keep
+            while ends and ends[0] <= base:
+                ends.pop(0)
+                stamps.pop(0)
+        conn.close()
+
+    def close(self):
+        self.server.close()
+
+
+class Console:
+    """The firmware console, as a child's pipes or a serial device."""
+
+    def __init__(self, write, read):
+        self.write_fn = write
+        self.output = bytearray()
+        self.cond = threading.Condition()
+        threading.Thread(target=self.reader, args=(read,),
+                         daemon=True).start()
+
+    def reader(self, read):
+        while True:
+            try:
+                data = read()
+            except OSError:
+                data = b""
+            if not data:
+                return
+            with self.cond:
+                self.output += data
+                self.cond.notify_all()
+
+    def mark(self):
+        with self.cond:
+            return len(self.output)
+
+    def wait(self, pattern, since, timeout=10.0):
+        deadline = time.monotonic() + timeout
+        with self.cond:
+            while pattern.encode() not in self.output[since:]:
+                left = deadline - time.monotonic()
+                if left <= 0:
+                    tail = bytes(self.output[-300:]).decode("latin-1")
+                    raise RuntimeError("no %r from the firmware; last output:"
+                                       "\n%s" % (pattern, tail))
+                self.cond.wait(left)
+
+    def search(self, regex, since, timeout=10.0):
+        deadline = time.monotonic() + timeout
+        with self.cond:
+            while True:
+                match = regex.search(self.output, since)
+                left = deadline - time.monotonic()
+                if match or left <= 0:
+                    return match
+                self.cond.wait(left)
+
+    def write(self, data):
+        if isinstance(data, str):
+            data = data.encode("latin-1")
+        self.write_fn(data)
+
+
+class Target:
+    """The host build against the simulator, started fresh for each run."""
+
+    def __init__(self, args):
+        sim = [sys.executable, os.path.join(HERE, "esp8266_sim.py"),
+               "--no-join"] + args.sim_arg
+        self.sim = subprocess.Popen(sim, stdout=subprocess.PIPE,
+                                    stderr=subprocess.DEVNULL)
+        pty = self.sim.stdout.readline().decode().strip()
+
+        # The module is on UART5, or on UART1 in a MODEM_UART1 build; the
+        # UART the firmware does not use is never opened.
+        env = dict(os.environ, HOST_UART1=pty, HOST_UART5=pty,
+                   HOST_LINGER_MS="100")
+        self.fw = subprocess.Popen([args.firmware], env=env,
+                                   stdin=subprocess.PIPE,
+                                   stdout=subprocess.PIPE,
+                                   stderr=subprocess.DEVNULL, bufsize=0)
+
+        def write(data):
+            self.fw.stdin.write(data)
+
+        self.console = Console(write,
+                               lambda: os.read(self.fw.stdout.fileno(), 4096))
+
+    def close(self):
+        for proc in (self.fw, self.sim):
+            proc.terminate()
+            try:
+                proc.wait(2)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+
+
+class Board:
+    """A real board, its console on a serial device."""
+
+    def __init__(self, args):
+        self.fd = os.open(args.console, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        attrs = termios.tcgetattr(self.fd)
+        speed = getattr(termios, "B%d" % args.console_baud)
+        attrs[4] = attrs[5] = speed
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+
+        def write(data):
+            os.write(self.fd, data)
+
+        self.console = Console(write, lambda: os.read(self.fd, 4096))
+        self.console.write("+++\r")
+
+    def close(self):
+        os.close(self.fd)
+
+
+def percentile(values, fraction):
+    if not values:
+        return None
+    index = min(len(values) - 1, max(0, int(len(values) * fraction + 0.5) - 1))
+    return values[index]
+
+
+def message(seq, size):
+    header = "#%d:%d:" % (seq, now_us())
+    return header + "." * max(0, size - len(header))
+
+
+def run(args, path, size, rate):
+    sink = Sink(args.listen)
+    target = Board(args) if args.console else Target(args)
+    console = target.console
+    dropped = None
+
+    try:
+        mark = console.mark() if args.console else 0
+        console.write("\r")
+        console.wait("Command List", mark)
+
+        # Open the link to the sink.
+        mark = console.mark()
+        console.write("3")
+        console.wait("port", mark)
+        console.write("%d\r" % sink.port)
+        console.wait("IP address", mark)
+        mark = console.mark()
+        console.write("%s\r" % args.server_ip)
+        console.wait("Command List", mark)
+
+        mark = console.mark()
+        if path == "passthrough":
+            console.write("4")
+            console.wait("+++ to exit", mark)
+            if args.coalesce:
+                console.write("++coalesce %d\r" % args.coalesce)
+            end = "\r"
+        else:
+            console.write("6")
+            console.wait("Transparent mode", mark)
+            end = ""
+
+        # Send on a fixed schedule; a rate of 0 sends back to back.
+        interval = 1.0 / rate if rate else 0
+        start = time.monotonic()
+        first = now_us()
+        with sink.lock:
+            sink.start = first
+        for seq in range(args.count):
+            if interval:
+                delay = start + seq * interval - time.monotonic()
+                if delay > 0:
+                    time.sleep(delay)
+            console.write(message(seq, size) + end)
+
+        # Wait for the stream to go quiet.
+        quiet = time.monotonic()
+        seen = -1
+        while time.monotonic() - quiet < args.drain:
+            with sink.lock:
+                got = len(sink.arrivals)
+            if got != seen:
+                seen = got
+                quiet = time.monotonic()
+            if got == args.count:
+                break
+            time.sleep(0.05)
+
+        if path == "transparent":
+            time.sleep(1.2)
+            console.write("+++")
+            time.sleep(1.2)
+        else:
+            # Ask the firmware how many typed bytes it had to drop, which
+            # tells messages lost on the console from those lost further on.
+            # The first return ends whatever is left of a cut short line.
+            mark = console.mark()
+            console.write("\r++stats\r")
+            match = console.search(DROPPED, mark)
+            if match:
+                dropped = int(match.group(1)) + int(match.group(2))
+            console.write("+++\r")
+    finally:
+        target.close()
+        sink.close()
+
+    with sink.lock:
+        arrivals = dict(sink.arrivals)
+        last = sink.last
+        received = sink.received
+
+    latencies = sorted(arrived - sent for sent, arrived in arrivals.values())
+    duration = (last - first) / 1e6 if arrivals else 0
+
+    return {
+        "revision": args.revision,
+        "path": path,
+        "size": size,
+        "rate": rate,
+        "coalesce": args.coalesce if path == "passthrough" else 0,
+        "sent": args.count,
+        "delivered": len(arrivals),
+        "lost": args.count - len(arrivals),
+        "fw_dropped": dropped,
+        "sent_bytes": args.count * size,
+        "received_bytes": received,
+        "duration_s": round(duration, 3),
+        "bytes_per_s": round(received / duration, 1) if duration else 0,
+        "msgs_per_s": round(len(arrivals) / duration, 1) if duration else 0,
+        "lat_min_us": latencies[0] if latencies else None,
+        "lat_p50_us": percentile(latencies, 0.50),
+        "lat_p90_us": percentile(latencies, 0.90),
+        "lat_p99_us": percentile(latencies, 0.99),
+        "lat_max_us": latencies[-1] if latencies else None,
+        "lat_mean_us": (sum(latencies) // len(latencies)) if latencies
+                       else None,
+    }
+
+
+def numbers(text):
+    return [int(item) for item in text.split(",") if item]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Benchmark the firmware's console to TCP server paths.")
+    parser.add_argument("--path", default="passthrough",
+                        help="passthrough, transparent or both, comma "
+                             "separated (default passthrough)")
+    parser.add_argument("--size", default="32",
+                        help="message sizes in bytes, comma separated; at "
+                             "most 126 for passthrough (default 32)")
+    parser.add_argument("--rate", default="20",
+                        help="messages per second, comma separated; 0 sends "
+                             "back to back (default 20)")
+    parser.add_argument("--count", type=int, default=100,
+                        help="messages per run (default 100)")
+    parser.add_argument("--coalesce", type=int, default=0, metavar="MS",
+                        help="type ++coalesce MS before a passthrough run")
+    parser.add_argument("--drain", type=float, default=2.0,
+                        help="seconds without arrivals that end a run "
+                             "(default 2)")
+    parser.add_argument("--firmware",
+                        default=os.path.join(ROOT, "host", "wifi_tiva_host"),
+                        help="host build to run")
+    parser.add_argument("--sim-arg", action="append", default=[],
+                        metavar="ARG",
+                        help="pass ARG to the simulator; may be repeated")
+    parser.add_argument("--console", metavar="DEVICE",
+                        help="benchmark a board on this serial console "
+                             "instead of the host build")
+    parser.add_argument("--console-baud", type=int, default=115200)
+    parser.add_argument("--listen", default="127.0.0.1",
+                        help="address the sink listens on")
+    parser.add_argument("--server-ip", default="127.0.0.1",
+                        help="address typed into the menu for the sink")
+    parser.add_argument("--csv", action="store_true",
+                        help="print CSV instead of JSON lines")
+    args = parser.parse_args()
+    args.revision = revision()
+
+    if args.csv:
+        print(",".join(FIELDS), flush=True)
+
+    for path in args.path.split(","):
+        for size in numbers(args.size):
+            for rate in numbers(args.rate):
+                result = run(args, path, size, rate)
+                if args.csv:
+                    print(",".join("" if result[field] is None
+                                   else str(result[field])
+                                   for field in FIELDS), flush=True)
+                else:
+                    print(json.dumps(result), flush=True)
+
+
+if __name__ == "__main__":
+    main()
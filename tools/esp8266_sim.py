@@ -0,0 +1,774 @@
+#!/usr/bin/env python3
+#
+# esp8266_sim.py - Stand-in for an ESP8266 running the AT firmware.
+#
+# Speaks the AT dialect main.c uses over a pseudo terminal and bridges the
+# TCP link to real sockets, so the firmware can be run against server.py on
+# one Linux box.  Point the host build at the pty it prints:
+#
+#   tools/esp8266_sim.py --scan-size 12 --latency 5 &
+#   HOST_UART5=/dev/pts/N host/wifi_tiva_host
+#
+# The scan list, command latency and link bandwidth are configurable and the
+# scan list is generated from a seed, so runs are repeatable.
+#
+
+import argparse
+import asyncio
+import os
+import random
+import re
+import signal
+import sys
+import termios
+import time
+import tty
+
+
+class Stats:
+    def __init__(self):
+        self.commands = {}
+        self.uart_rx = 0
+        self.uart_tx = 0
+        self.tcp_tx = 0
+        self.tcp_rx = 0
+        self.busy = 0
+        self.stalled = 0
+        self.garbled = 0
+        self.start = time.monotonic()
+
+    def report(self, out):
+        elapsed = time.monotonic() - self.start
+        out.write("sim: %.3f s, uart rx %d tx %d, tcp tx %d rx %d, busy %d, "
+                  "stalled %d, garbled %d\n" %
+                  (elapsed, self.uart_rx, self.uart_tx, self.tcp_tx,
+                   self.tcp_rx, self.busy, self.stalled, self.garbled))
+        for name in sorted(self.commands):
+            out.write("sim:   %-12s %d\n" % (name, self.commands[name]))
+        out.flush()
+
+
+class AccessPoint:
+    def __init__(self, ssid, rssi, channel, ecn, bssid, password=None):
+        self.ssid = ssid
+        self.rssi = rssi
+        self.channel = channel
+        self.ecn = ecn
+        self.bssid = bssid
+        self.password = password
+
+    def cwlap(self, mask=0x7f):
+        # AT+CWLAPOPT's mask picks fields in this order.
+        fields = [str(self.ecn), '"%s"' % self.ssid, str(self.rssi),
+                  '"%s"' % self.bssid, str(self.channel), "-12", "0"]
+        return "+CWLAP:(%s)" % ",".join(
+            field for bit, field in enumerate(fields) if mask & (1 << bit))
+
+
+def make_scan_list(args):
+    rng = random.Random(args.seed)
+    aps = []
+
+    for spec in args.ap:
+        fields = spec.split(",")
+        ssid = fields[0]
+        password = fields[1] if len(fields) > 1 and fields[1] else None
+        rssi = int(fields[2]) if len(fields) > 2 else -40
+        channel = int(fields[3]) if len(fields) > 3 else 6
+        ecn = 3 if password else 0
+        aps.append(AccessPoint(ssid, rssi, channel, ecn,
+                               "02:00:00:00:%02x:%02x" % (len(aps) >> 8,
+                                                          len(aps) & 0xff),
+                               password))
+
+    for index in range(args.scan_size):
+        bssid = ":".join("%02x" % rng.randrange(256) for _ in range(6))
+        aps.append(AccessPoint("sim-ap-%02d" % index, rng.randrange(-95, -30),
+                               rng.randrange(1, 14), rng.choice([0, 2, 3, 4]),
+                               bssid, None))
+
+    return aps
+
+
+# The baud rates a terminal speed can stand for.
+TERM_SPEEDS = {getattr(termios, "B%d" % rate): rate
+               for rate in (9600, 19200, 38400, 57600, 115200, 230400,
+                            460800, 921600)}
+
+
+class Modem:
+    def __init__(self, args, fd, stats, slave=None):
+        self.args = args
+        self.fd = fd
+        self.slave = slave
+        self.stats = stats
+        self.rng = random.Random(args.seed)
+        self.loop = asyncio.get_event_loop()
+        self.aps = make_scan_list(args)
+
+        self.echo = True
+        self.mode = 1
+        self.joined = None
+        self.busy = False
+
+        # AT+UART_CUR.  The host build sets the pty's speed to the rate
+        # the firmware's UART runs at; when the two differ nothing gets
+        # through either way, and above --max-baud what the module sends
+        # arrives garbled.  Flow control bit 1 has the module watch its CTS,
+        # which the pty stands for with CRTSCTS: the host build only holds
+        # the module off with RTS while it is set.
+        self.baud = args.baud
+        self.flow = 0
+
+        # AT+CWLAPOPT: whether scans are sorted by RSSI, and the fields
+        # they show.
+        self.lap_sort = False
+        self.lap_mask = 0x7f
+        self.line = bytearray()
+
+        # Commands taken outside a stall, and until when the modem plays
+        # dead.
+        self.commands = 0
+        self.stall_until = 0
+
+        # Bytes still expected after a CIPSEND prompt, and where they go.
+        self.send_left = 0
+        self.send_buf = bytearray()
+
+        # Transparent transmission: UART bytes are packed into a TCP write
+        # 20 ms after the first byte of the packet or at 2048 bytes, as the
+        # module sends every 20 ms however steady the stream, and a packet
+        # that is just "+++" leaves the mode.
+        self.cipmode = 0
+        self.transparent = False
+        self.packet = bytearray()
+        self.packet_timer = None
+
+        # Open TCP links by link ID, as (reader, writer).  Without
+        # AT+CIPMUX=1 the only link is 0 and responses carry no link ID.
+        self.cipmux = 0
+        self.links = {}
+        self.send_link = 0
+
+        self.out = bytearray()
+        self.writing = False
+        self.bucket = TokenBucket(args.bandwidth)
+
+        self.latency = {}
+        for spec in args.cmd_latency:
+            name, _, ms = spec.partition("=")
+            self.latency[name.upper()] = float(ms) / 1000.0
+
+    #
+    # UART side.
+    #
+    def peer_baud(self):
+        if self.slave is None:
+            return None
+        try:
+            return TERM_SPEEDS.get(termios.tcgetattr(self.slave)[5])
+        except termios.error:
+            return None
+
+    def set_flow(self, flow):
+        self.flow = flow
+        if self.slave is None:
+            return
+        try:
+            attrs = termios.tcgetattr(self.slave)
+            if flow & 2:
+                attrs[2] |= termios.CRTSCTS
+            else:
+                attrs[2] &= ~termios.CRTSCTS
+            termios.tcsetattr(self.slave, termios.TCSANOW, attrs)
+        except termios.error:
+            pass
+
+    def garble(self, count):
+        self.stats.garbled += count
+        return bytes(self.rng.randrange(0x80, 0x100) for _ in range(count))
+
+    def write(self, data):
+        if isinstance(data, str):
+            data = data.encode("latin-1")
+        peer = self.peer_baud()
+        if ((peer and peer != self.baud) or
+                (self.args.max_baud and self.baud > self.args.max_baud)):
+            data = self.garble(len(data))
+        self.stats.uart_tx += len(data)
+        if self.args.verbose:
+            sys.stderr.write("sim > %r\n" % bytes(data))
+        self.out += data
+        if not self.writing:
+            self.writing = True
+            self.loop.add_writer(self.fd, self.flush)
+
+    def flush(self):
+        try:
+            count = os.write(self.fd, self.out)
+        except BlockingIOError:
+            return
+        except OSError:
+            count = len(self.out)
+        del self.out[:count]
+        if not self.out:
+            self.loop.remove_writer(self.fd)
+            self.writing = False
+
+    def readable(self):
+        try:
+            data = os.read(self.fd, 4096)
+        except (BlockingIOError, InterruptedError):
+            return
+        except OSError:
+            # No one has the pty open; wait for the firmware to start.
+            self.loop.remove_reader(self.fd)
+            self.loop.call_later(0.1, self.loop.add_reader, self.fd,
+                                 self.readable)
+            return
+
+        self.stats.uart_rx += len(data)
+        if self.args.verbose:
+            sys.stderr.write("sim < %r\n" % data)
+
+        peer = self.peer_baud()
+        if peer and peer != self.baud:
+            self.stats.garbled += len(data)
+            self.line.clear()
+            return
+
+        for byte in data:
+            self.receive(byte)
+
+    def receive(self, byte):
+        if self.transparent:
+            self.packet.append(byte)
+            if len(self.packet) >= 2048:
+                if self.packet_timer:
+                    self.packet_timer.cancel()
+                self.end_packet()
+            elif not self.packet_timer:
+                self.packet_timer = self.loop.call_later(
+                    self.args.packet_time / 1000.0, self.end_packet)
+            return
+
+        if self.send_left:
+            self.send_buf.append(byte)
+            self.send_left -= 1
+            if not self.send_left:
+                data = bytes(self.send_buf)
+                self.send_buf.clear()
+                self.loop.create_task(self.send_data(data))
+            return
+
+        if byte == 0x0a:
+            line = bytes(self.line).rstrip(b"\r").decode("latin-1")
+            self.line.clear()
+            if line:
+                self.command(line)
+            return
+
+        self.line.append(byte)
+
+    def command(self, line):
+        if time.monotonic() < self.stall_until:
+            self.stats.stalled += 1
+            return
+
+        self.commands += 1
+        if (self.args.stall_after and
+                self.commands % self.args.stall_after == 0):
+            self.stall_until = time.monotonic() + self.args.stall_ms / 1000.0
+            self.stats.stalled += 1
+            return
+
+        if self.echo:
+            self.write(line + "\r\r\n")
+
+        if self.busy:
+            self.stats.busy += 1
+            self.write("busy p...\r\n")
+            return
+
+        self.busy = True
+        self.loop.create_task(self.run(line))
+
+    async def run(self, line):
+        match = re.match(r"AT(\+?[A-Z_]*|E[01])(.*)$", line, re.I)
+        name = match.group(1).upper().lstrip("+") if match else ""
+        rest = match.group(2) if match else ""
+        self.stats.commands[name or "AT"] = \
+            self.stats.commands.get(name or "AT", 0) + 1
+
+        delay = self.latency.get(name, self.args.latency / 1000.0)
+        if delay:
+            await asyncio.sleep(delay)
+
+        handler = getattr(self, "cmd_" + name, None) if match else None
+        try:
+            if handler:
+                await handler(rest)
+            elif match and name == "":
+                self.ok()
+            else:
+                self.error()
+        finally:
+            self.busy = False
+
+    def ok(self):
+        self.write("\r\nOK\r\n")
+
+    def error(self):
+        self.write("\r\nERROR\r\n")
+
+    #
+    # Basic commands.
+    #
+    async def cmd_E0(self, rest):
+        self.echo = False
+        self.ok()
+
+    async def cmd_E1(self, rest):
+        self.echo = True
+        self.ok()
+
+    async def cmd_RST(self, rest):
+        self.ok()
+        await self.reboot()
+
+    async def cmd_RESTORE(self, rest):
+        self.ok()
+        self.mode = 1
+        await self.reboot()
+
+    async def cmd_UART_CUR(self, rest):
+        if rest == "?":
+            self.write("+UART_CUR:%d,8,1,0,%d\r\n" % (self.baud, self.flow))
+            self.ok()
+            return
+        match = re.match(r"=(\d+),8,1,0,([0-3])$", rest)
+        if not match or not 110 <= int(match.group(1)) <= 4608000:
+            self.error()
+            return
+        # The answer goes out at the old rate.
+        self.ok()
+        self.baud = int(match.group(1))
+        self.set_flow(int(match.group(2)))
+
+    async def cmd_GMR(self, rest):
+        self.write("AT version:1.2.0.0(simulated)\r\nSDK version:2.0.0\r\n")
+        self.ok()
+
+    async def reboot(self):
+        self.close_link(report=False)
+        self.joined = None
+        self.echo = True
+        self.baud = self.args.baud
+        self.set_flow(0)
+        self.cipmode = 0
+        self.cipmux = 0
+        self.lap_sort = False
+        self.lap_mask = 0x7f
+        await asyncio.sleep(self.args.boot_time / 1000.0)
+        self.write("\r\n ets Jan  8 2013,rst cause:2, boot mode:(3,7)\r\n"
+                   "\r\nready\r\n")
+
+    #
+    # Wi-Fi.
+    #
+    async def cmd_CWMODE(self, rest):
+        if rest == "?":
+            self.write("+CWMODE:%d\r\n" % self.mode)
+            self.ok()
+        elif re.match(r"=[123]$", rest):
+            self.mode = int(rest[1])
+            self.ok()
+        else:
+            self.error()
+
+    async def cmd_CWLAP(self, rest):
+        if self.mode == 2:
+            self.error()
+            return
+        aps = self.aps
+        if self.lap_sort:
+            aps = sorted(aps, key=lambda ap: -ap.rssi)
+        for ap in aps:
+            self.write(ap.cwlap(self.lap_mask) + "\r\n")
+        self.ok()
+
+    async def cmd_CWLAPOPT(self, rest):
+        match = re.match(r"=([01]),(\d+)$", rest)
+        if not match:
+            self.error()
+            return
+        self.lap_sort = match.group(1) == "1"
+        self.lap_mask = int(match.group(2))
+        self.ok()
+
+    async def cmd_CWJAP(self, rest):
+        if rest == "?":
+            if self.joined:
+                ap = self.joined
+                self.write('+CWJAP:"%s","%s",%d,%d\r\n' %
+                           (ap.ssid, ap.bssid, ap.channel, ap.rssi))
+                self.ok()
+            else:
+                self.write("No AP\r\n")
+                self.ok()
+            return
+
+        match = re.match(r'="((?:[^"\\]|\\.)*)","((?:[^"\\]|\\.)*)"', rest)
+        if not match or self.mode == 2:
+            self.error()
+            return
+
+        ssid, password = match.group(1), match.group(2)
+        self.close_link()
+        if self.joined:
+            self.joined = None
+            self.write("WIFI DISCONNECT\r\n")
+
+        ap = next((ap for ap in self.aps if ap.ssid == ssid), None)
+        await asyncio.sleep(self.args.join_time / 1000.0)
+
+        if ap is None:
+            self.write("+CWJAP:3\r\n\r\nFAIL\r\n")
+        elif ap.password is not None and ap.password != password:
+            self.write("+CWJAP:2\r\n\r\nFAIL\r\n")
+        else:
+            self.joined = ap
+            self.write("WIFI CONNECTED\r\nWIFI GOT IP\r\n")
+            self.ok()
+
+    async def cmd_CWQAP(self, rest):
+        self.close_link()
+        if self.joined:
+            self.joined = None
+            self.write("WIFI DISCONNECT\r\n")
+        self.ok()
+
+    async def cmd_CIFSR(self, rest):
+        self.write('+CIFSR:STAIP,"%s"\r\n' %
+                   ("192.168.4.2" if self.joined else "0.0.0.0"))
+        self.ok()
+
+    #
+    # TCP links.
+    #
+    def link_id(self, link):
+        return "%d," % link if self.cipmux else ""
+
+    def writer(self, link):
+        return self.links[link][1] if link in self.links else None
+
+    async def cmd_CIPSTATUS(self, rest):
+        status = 3 if self.links else (2 if self.joined else 5)
+        self.write("STATUS:%d\r\n" % status)
+        for link in sorted(self.links):
+            self.write('+CIPSTATUS:%d,"TCP"\r\n' % link)
+        self.ok()
+
+    async def cmd_CIPMUX(self, rest):
+        if rest == "?":
+            self.write("+CIPMUX:%d\r\n" % self.cipmux)
+            self.ok()
+        elif rest in ("=0", "=1"):
+            if self.links:
+                self.write("link is builded\r\n")
+                self.error()
+            elif self.cipmode == 1 and rest == "=1":
+                self.error()
+            else:
+                self.cipmux = int(rest[1])
+                self.ok()
+        else:
+            self.error()
+
+    async def cmd_CIPSTART(self, rest):
+        if self.cipmux:
+            match = re.match(r'=([0-4]),"(TCP)","([^"]+)",(\d+)', rest, re.I)
+        else:
+            match = re.match(r'=()"(TCP)","([^"]+)",(\d+)', rest, re.I)
+        if not match:
+            self.error()
+            return
+        link = int(match.group(1) or 0)
+        if link in self.links:
+            self.write("ALREADY CONNECTED\r\n")
+            self.error()
+            return
+        if not self.joined and not self.args.no_join:
+            self.error()
+            return
+
+        host = self.args.remap or match.group(3)
+        try:
+            reader, writer = await asyncio.open_connection(
+                host, int(match.group(4)))
+        except OSError:
+            self.error()
+            self.write("%sCLOSED\r\n" % self.link_id(link))
+            return
+
+        self.links[link] = (reader, writer)
+        self.write("%sCONNECT\r\n" % self.link_id(link))
+        self.ok()
+        self.loop.create_task(self.receive_link(link, reader))
+
+    async def cmd_CIPMODE(self, rest):
+        if rest == "?":
+            self.write("+CIPMODE:%d\r\n" % self.cipmode)
+            self.ok()
+        elif rest in ("=0", "=1"):
+            if self.cipmux and rest == "=1":
+                self.error()
+                return
+            self.cipmode = int(rest[1])
+            self.ok()
+        else:
+            self.error()
+
+    def end_packet(self):
+        self.packet_timer = None
+        data = bytes(self.packet)
+        self.packet.clear()
+        if not data:
+            return
+        if data == b"+++":
+            self.transparent = False
+            self.stats.commands["+++"] = self.stats.commands.get("+++", 0) + 1
+            return
+        if self.writer(0):
+            self.loop.create_task(self.send_stream(self.writer(0), data))
+
+    async def send_stream(self, writer, data):
+        await self.bucket.take(len(data))
+        try:
+            writer.write(data)
+            await writer.drain()
+            self.stats.tcp_tx += len(data)
+        except OSError:
+            pass
+
+    async def cmd_CIPSEND(self, rest):
+        if rest == "" and self.cipmode == 1:
+            if not self.writer(0):
+                self.write("link is not valid\r\n")
+                self.error()
+                return
+            self.write("\r\nOK\r\n\r\n>")
+            self.transparent = True
+            return
+
+        if self.cipmux:
+            match = re.match(r"=([0-4]),(\d+)$", rest)
+        else:
+            match = re.match(r"=()(\d+)$", rest)
+        if not match or not 0 < int(match.group(2)) <= 2048:
+            self.error()
+            return
+        link = int(match.group(1) or 0)
+        if not self.writer(link):
+            self.write("link is not valid\r\n")
+            self.error()
+            return
+
+        # Hold the busy flag until the data has been sent.
+        self.write("\r\nOK\r\n> ")
+        self.send_link = link
+        self.send_left = int(match.group(2))
+        self.send_done = self.loop.create_future()
+        await self.send_done
+
+    async def send_data(self, data):
+        self.write("\r\nRecv %d bytes\r\n" % len(data))
+        writer = self.writer(self.send_link)
+        ok = writer is not None
+
+        if ok:
+            await self.bucket.take(len(data))
+            try:
+                writer.write(data)
+                await writer.drain()
+                self.stats.tcp_tx += len(data)
+            except OSError:
+                ok = False
+
+        self.write("\r\nSEND OK\r\n" if ok else "\r\nSEND FAIL\r\n")
+        if not self.send_done.done():
+            self.send_done.set_result(None)
+
+    async def cmd_CIPCLOSE(self, rest):
+        if self.cipmux:
+            match = re.match(r"=([0-5])$", rest)
+        else:
+            match = re.match(r"()$", rest)
+        if not match:
+            self.error()
+            return
+        link = int(match.group(1) or 0)
+        if link == 5 and self.links:
+            self.close_link()
+        elif link in self.links:
+            self.close_link(link)
+        else:
+            self.error()
+            return
+        self.ok()
+
+    def close_link(self, link=None, report=True):
+        """Closes one link, or all of them."""
+        self.transparent = False
+        for index in sorted(self.links) if link is None else [link]:
+            if index not in self.links:
+                continue
+            self.links.pop(index)[1].close()
+            if report:
+                self.write("%sCLOSED\r\n" % self.link_id(index))
+
+    async def receive_link(self, link, reader):
+        while True:
+            try:
+                data = await reader.read(self.args.ipd_size)
+            except OSError:
+                data = b""
+
+            if link not in self.links or self.links[link][0] is not reader:
+                return
+
+            if not data:
+                self.close_link(link)
+                return
+
+            await self.bucket.take(len(data))
+            self.stats.tcp_rx += len(data)
+            if self.transparent:
+                self.write(data)
+            else:
+                self.write(b"\r\n+IPD,%s%d:" %
+                           (self.link_id(link).encode(), len(data)) + data)
+
+
+class TokenBucket:
+    """Limits a byte stream to a rate, with one second of burst."""
+
+    def __init__(self, rate):
+        self.rate = rate
+        self.tokens = rate
+        self.stamp = time.monotonic()
+
+    async def take(self, count):
+        if not self.rate:
+            return
+        now = time.monotonic()
+        self.tokens = min(self.rate, self.tokens + (now - self.stamp) * self.rate)
+        self.stamp = now
+        self.tokens -= count
+        if self.tokens < 0:
+            await asyncio.sleep(-self.tokens / self.rate)
+
+
+def open_port(args):
+    if args.device:
+        fd = os.open(args.device, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        if os.isatty(fd):
+            tty.setraw(fd)
+        return fd, args.device, None
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+
+    # Start the pty at the module's rate, for a peer that never sets it.
+    attrs = termios.tcgetattr(slave)
+    for speed, rate in TERM_SPEEDS.items():
+        if rate == args.baud:
+            attrs[4] = attrs[5] = speed
+    termios.tcsetattr(slave, termios.TCSANOW, attrs)
+    path = os.ttyname(slave)
+
+    # Keep the slave open so reads do not fail between firmware runs.
+    os.set_blocking(master, False)
+
+    if args.link:
+        try:
+            os.unlink(args.link)
+        except FileNotFoundError:
+            pass
+        os.symlink(path, args.link)
+        path = args.link
+
+    return master, path, slave
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Simulate an ESP8266 running the AT firmware on a pty.")
+    parser.add_argument("--device", help="use this tty instead of a new pty")
+    parser.add_argument("--link", help="symlink the pty to this path")
+    parser.add_argument("--scan-size", type=int, default=8,
+                        help="generated access points in a scan (default 8)")
+    parser.add_argument("--ap", action="append", default=[],
+                        metavar="SSID[,PASSWORD[,RSSI[,CHANNEL]]]",
+                        help="add an access point; may be repeated")
+    parser.add_argument("--seed", type=int, default=1,
+                        help="seed for the generated scan list")
+    parser.add_argument("--latency", type=float, default=0,
+                        help="delay before every response, in ms")
+    parser.add_argument("--cmd-latency", action="append", default=[],
+                        metavar="CMD=MS",
+                        help="delay for one command, e.g. CWLAP=2000")
+    parser.add_argument("--join-time", type=float, default=0,
+                        help="extra time AT+CWJAP takes, in ms")
+    parser.add_argument("--boot-time", type=float, default=200,
+                        help="time from reset to ready, in ms (default 200)")
+    parser.add_argument("--bandwidth", type=float, default=0,
+                        help="TCP link rate in bytes/s, each way (0: no limit)")
+    parser.add_argument("--ipd-size", type=int, default=1460,
+                        help="largest +IPD block (default 1460)")
+    parser.add_argument("--packet-time", type=float, default=20,
+                        help="time from the first byte of a transparent "
+                             "mode packet to its send, in ms (default 20)")
+    parser.add_argument("--remap", metavar="HOST",
+                        help="connect to HOST whatever CIPSTART asks for")
+    parser.add_argument("--stall-after", type=int, default=0, metavar="N",
+                        help="ignore every Nth command and whatever follows "
+                             "it for --stall-ms")
+    parser.add_argument("--stall-ms", type=float, default=3000,
+                        help="length of a stall (default 3000)")
+    parser.add_argument("--baud", type=int, default=115200,
+                        help="UART rate after a reset (default 115200)")
+    parser.add_argument("--max-baud", type=int, default=0,
+                        help="garble what is sent above this rate "
+                             "(0: no limit)")
+    parser.add_argument("--no-join", action="store_true",
+                        help="allow CIPSTART without joining an AP first")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="log UART traffic on stderr")
+    args = parser.parse_args()
+
+    fd, path, slave = open_port(args)
+    print(path, flush=True)
+
+    stats = Stats()
+    loop = asyncio.new_event_loop()
+    asyncio.set_event_loop(loop)
+    modem = Modem(args, fd, stats, slave)
+    loop.add_reader(fd, modem.readable)
+
+    for signum in (signal.SIGINT, signal.SIGTERM):
+        loop.add_signal_handler(signum, loop.stop)
+
+    try:
+        loop.run_forever()
+    finally:
+        stats.report(sys.stderr)
+        if args.link:
+            try:
+                os.unlink(args.link)
+            except OSError:
+                pass
+
+
+if __name__ == "__main__":
+    main()